@@ -874,7 +874,7 @@ EGifCompressLine(GifFileType *GifFile,
                  const int LineLen)
 {
     int i = 0, CrntCode, NewCode;
-    unsigned long NewKey;
+    uint32_t Slot;
     GifPixelType Pixel;
     GifHashTableType *HashTable;
     GifFilePrivateType *Private = (GifFilePrivateType *) GifFile->Private;
@@ -888,11 +888,10 @@ EGifCompressLine(GifFileType *GifFile,
 
     while (i < LineLen) {   /* Decode LineLen items. */
         Pixel = Line[i++];  /* Get next pixel from stream. */
-        /* Form a new unique key to search hash table for the code combines 
-         * CrntCode as Prefix string with Pixel as postfix char.
+        /* Search the hash table for the string made of CrntCode as Prefix
+         * string with Pixel as postfix char.
          */
-        NewKey = (((uint32_t) CrntCode) << 8) + Pixel;
-        if ((NewCode = _ExistsHashTable(HashTable, NewKey)) >= 0) {
+        if ((NewCode = _LookupHashTable(HashTable, CrntCode, Pixel, &Slot)) >= 0) {
             /* This Key is already there, or the string is old one, so
              * simple take new code as our CrntCode:
              */
@@ -905,7 +904,6 @@ EGifCompressLine(GifFileType *GifFile,
                 GifFile->Error = E_GIF_ERR_DISK_IS_FULL;
                 return GIF_ERROR;
             }
-            CrntCode = Pixel;
 
             /* If however the HashTable if full, we send a clear first and
              * Clear the hash table.
@@ -922,9 +920,12 @@ EGifCompressLine(GifFileType *GifFile,
                 Private->MaxCode1 = 1 << Private->RunningBits;
                 _ClearHashTable(HashTable);
             } else {
-                /* Put this unique key with its relative Code in hash table: */
-                _InsertHashTable(HashTable, NewKey, Private->RunningCode++);
+                /* Put this unique key with its relative Code in hash table,
+                 * into the free slot the lookup stopped at:
+                 */
+                _InsertHashSlot(HashTable, Slot, CrntCode, Pixel, Private->RunningCode++);
             }
+            CrntCode = Pixel;
         }
 
     }
@@ -28,8 +28,6 @@ static long NumberOfTests = 0,
 	    NumberOfMisses = 0;
 #endif	/* DEBUG_HIT_RATE */
 
-static int KeyItem(uint32_t Item);
-
 /******************************************************************************
  Initialize HashTable - allocate the memory needed and clear it.	      *
 ******************************************************************************/
@@ -53,6 +51,7 @@ GifHashTableType *_InitHashTable(void)
 void _ClearHashTable(GifHashTableType *HashTable)
 {
     memset(HashTable -> HTable, 0xFF, HT_SIZE * sizeof(uint32_t));
+    memset(HashTable -> LastChild, 0xFF, (HT_MAX_CODE + 1) * sizeof(uint32_t));
 }
 
 /******************************************************************************
@@ -61,21 +60,15 @@ void _ClearHashTable(GifHashTableType *HashTable)
 ******************************************************************************/
 void _InsertHashTable(GifHashTableType *HashTable, uint32_t Key, int Code)
 {
-    int HKey = KeyItem(Key);
-    uint32_t *HTable = HashTable -> HTable;
+    uint32_t Slot;
 
 #ifdef DEBUG_HIT_RATE
 	NumberOfTests++;
 	NumberOfMisses++;
 #endif /* DEBUG_HIT_RATE */
 
-    while (HT_GET_KEY(HTable[HKey]) != 0xFFFFFL) {
-#ifdef DEBUG_HIT_RATE
-	    NumberOfMisses++;
-#endif /* DEBUG_HIT_RATE */
-	HKey = (HKey + 1) & HT_KEY_MASK;
-    }
-    HTable[HKey] = HT_PUT_KEY(Key) | HT_PUT_CODE(Code);
+    if (_LookupHashTable(HashTable, Key >> 8, Key & 0xFF, &Slot) < 0)
+        _InsertHashSlot(HashTable, Slot, Key >> 8, Key & 0xFF, Code);
 }
 
 /******************************************************************************
@@ -84,35 +77,14 @@ void _InsertHashTable(GifHashTableType *HashTable, uint32_t Key, int Code)
 ******************************************************************************/
 int _ExistsHashTable(GifHashTableType *HashTable, uint32_t Key)
 {
-    int HKey = KeyItem(Key);
-    uint32_t *HTable = HashTable -> HTable, HTKey;
+    uint32_t Slot;
 
 #ifdef DEBUG_HIT_RATE
 	NumberOfTests++;
 	NumberOfMisses++;
 #endif /* DEBUG_HIT_RATE */
 
-    while ((HTKey = HT_GET_KEY(HTable[HKey])) != 0xFFFFFL) {
-#ifdef DEBUG_HIT_RATE
-	    NumberOfMisses++;
-#endif /* DEBUG_HIT_RATE */
-	if (Key == HTKey) return HT_GET_CODE(HTable[HKey]);
-	HKey = (HKey + 1) & HT_KEY_MASK;
-    }
-
-    return -1;
-}
-
-/******************************************************************************
- Routine to generate an HKey for the hashtable out of the given unique key.  *
- The given Key is assumed to be 20 bits as follows: lower 8 bits are the     *
- new postfix character, while the upper 12 bits are the prefix code.	      *
- Because the average hit ratio is only 2 (2 hash references per entry),      *
- evaluating more complex keys (such as twin prime keys) does not worth it!   *
-******************************************************************************/
-static int KeyItem(uint32_t Item)
-{
-    return ((Item >> 12) ^ Item) & HT_KEY_MASK;
+    return _LookupHashTable(HashTable, Key >> 8, Key & 0xFF, &Slot);
 }
 
 #ifdef	DEBUG_HIT_RATE
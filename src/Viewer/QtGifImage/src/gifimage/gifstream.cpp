@@ -0,0 +1,127 @@
+/****************************************************************************
+** Copyright (c) 2013 Debao Zhang <hello@debao.me>
+** All right reserved.
+**
+** Permission is hereby granted, free of charge, to any person obtaining
+** a copy of this software and associated documentation files (the
+** "Software"), to deal in the Software without restriction, including
+** without limitation the rights to use, copy, modify, merge, publish,
+** distribute, sublicense, and/or sell copies of the Software, and to
+** permit persons to whom the Software is furnished to do so, subject to
+** the following conditions:
+**
+** The above copyright notice and this permission notice shall be
+** included in all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+** EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+** MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+** NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+** LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+** OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+** WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "gifstream.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+int writeToString(GifFileType *gifFile, const GifByteType *data, int size)
+{
+    static_cast<std::string *>(gifFile->UserData)->append(reinterpret_cast<const char *>(data), size);
+    return size;
+}
+
+/*
+    Opens a GIF89 file that writes into \a data and puts the screen
+    descriptor with the global color map into it. Returns 0 on error.
+*/
+GifFileType *openScreen(std::string &data, const GifStream::Screen &screen)
+{
+    int error;
+    GifFileType *gifFile = EGifOpen(&data, writeToString, &error);
+    if (!gifFile)
+        return 0;
+    //Graphics control and application extensions need GIF89.
+    EGifSetGifVersion(gifFile, true);
+    if (EGifPutScreenDesc(gifFile, screen.width, screen.height, 8,
+                          screen.backgroundIndex, screen.colorMap) == GIF_ERROR) {
+        EGifCloseFile(gifFile);
+        return 0;
+    }
+    return gifFile;
+}
+
+/*
+    Closes \a gifFile, which writes the trailer, and returns the bytes of
+    \a data from \a begin up to the trailer, or an empty string on error.
+*/
+std::string closeAndCut(GifFileType *gifFile, bool ok, std::string &data, size_t begin)
+{
+    const size_t end = data.size();
+    if (EGifCloseFile(gifFile) == GIF_ERROR || !ok
+            || data.size() != end + 1 || data[end] != GifStream::Trailer)
+        return std::string();
+    return data.substr(begin, end - begin);
+}
+}
+
+/*
+    Returns the signature, the logical screen descriptor with the global
+    color map of \a screen and the NETSCAPE2.0 extension with \a loopCount
+    (0 loops forever). Returns an empty string on error.
+*/
+std::string GifStream::header(const Screen &screen, int loopCount)
+{
+    std::string data;
+    GifFileType *gifFile = openScreen(data, screen);
+    if (!gifFile)
+        return std::string();
+
+    unsigned char data8[12] = "NETSCAPE2.0";
+    unsigned char loop[3];
+    loop[0] = 0x01;
+    loop[1] = loopCount & 0xFF;
+    loop[2] = (loopCount >> 8) & 0xFF;
+    bool ok = EGifPutExtensionLeader(gifFile, APPLICATION_EXT_FUNC_CODE) != GIF_ERROR
+            && EGifPutExtensionBlock(gifFile, 11, data8) != GIF_ERROR
+            && EGifPutExtensionBlock(gifFile, 3, loop) != GIF_ERROR
+            && EGifPutExtensionTrailer(gifFile) != GIF_ERROR;
+    return closeAndCut(gifFile, ok, data, 0);
+}
+
+/*
+    Returns the graphics control extension \a gcb, the image descriptor and
+    the LZW-compressed \a pixels of one frame at \a left, \a top on the
+    canvas. \a stride is the distance between rows of \a pixels in bytes.
+    The LZW code size comes from \a localMap, or from the global color map
+    of \a screen if \a localMap is 0, as a decoder reads it. The block does
+    not depend on the other frames. Returns an empty string on error.
+*/
+std::string GifStream::frame(const Screen &screen, const GifByteType *pixels, int stride,
+                             int left, int top, int width, int height,
+                             const GraphicsControlBlock &gcb, const ColorMapObject *localMap)
+{
+    std::string data;
+    GifFileType *gifFile = openScreen(data, screen);
+    if (!gifFile)
+        return std::string();
+    //The screen descriptor only sets up giflib and is cut off.
+    const size_t begin = data.size();
+
+    GifByteType gcbData[4];
+    size_t gcbLength = EGifGCBToExtension(&gcb, gcbData);
+    bool ok = EGifPutExtension(gifFile, GRAPHICS_EXT_FUNC_CODE, gcbLength, gcbData) != GIF_ERROR
+            && EGifPutImageDesc(gifFile, left, top, width, height, false, localMap) != GIF_ERROR;
+
+    //EGifPutLine() masks the line in place, so the rows are copied.
+    std::vector<GifPixelType> line(width);
+    for (int row = 0; ok && row < height; ++row) {
+        memcpy(line.data(), pixels + row * stride, width);
+        ok = EGifPutLine(gifFile, line.data(), width) != GIF_ERROR;
+    }
+    return closeAndCut(gifFile, ok, data, begin);
+}
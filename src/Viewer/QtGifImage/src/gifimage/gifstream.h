@@ -0,0 +1,66 @@
+/****************************************************************************
+** Copyright (c) 2013 Debao Zhang <hello@debao.me>
+** All right reserved.
+**
+** Permission is hereby granted, free of charge, to any person obtaining
+** a copy of this software and associated documentation files (the
+** "Software"), to deal in the Software without restriction, including
+** without limitation the rights to use, copy, modify, merge, publish,
+** distribute, sublicense, and/or sell copies of the Software, and to
+** permit persons to whom the Software is furnished to do so, subject to
+** the following conditions:
+**
+** The above copyright notice and this permission notice shall be
+** included in all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+** EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+** MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+** NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+** LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+** OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+** WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef GIFSTREAM_H
+#define GIFSTREAM_H
+
+#include "gif_lib.h"
+
+#include <string>
+
+/*
+    Parts of a gif file written frame by frame: the header, the frame blocks
+    and the trailer. Each part is encoded with giflib into a string of its
+    own, so frame blocks can be compressed on different threads and written
+    in order later. The parts do not depend on Qt.
+*/
+namespace GifStream
+{
+
+/*
+    Logical screen of the file. Every frame block is encoded against the
+    same screen as the header, so giflib sees a complete file.
+*/
+struct Screen
+{
+    int width;
+    int height;
+    int backgroundIndex;
+    const ColorMapObject *colorMap; //Global color map, may be 0
+};
+
+/*
+    The gif trailer, written after the last frame block.
+*/
+const char Trailer = ';';
+
+std::string header(const Screen &screen, int loopCount);
+std::string frame(const Screen &screen, const GifByteType *pixels, int stride,
+                  int left, int top, int width, int height,
+                  const GraphicsControlBlock &gcb,
+                  const ColorMapObject *localMap);
+
+}
+
+#endif // GIFSTREAM_H
@@ -24,10 +24,13 @@
 ****************************************************************************/
 #include "qgifimage.h"
 #include "qgifimage_p.h"
+#include "gifstream.h"
 #include <QFile>
 #include <QImage>
 #include <QDebug>
 #include <QScopedPointer>
+#include <QThread>
+#include <QtConcurrent>
 
 namespace
 {
@@ -40,17 +43,35 @@ int readFromIODevice(GifFileType *gifFile, GifByteType *data, int maxSize)
 {
     return static_cast<QIODevice *>(gifFile->UserData)->read(reinterpret_cast<char *>(data), maxSize);
 }
+
+/*
+    Compresses one indexed frame into a frame block of the stream, see
+    GifStream::frame(). Takes ownership of \a screenMap and \a localMap.
+*/
+QByteArray encodeFrameBlock(const QImage &image, const QPoint &offset, const GraphicsControlBlock &gcbBlock,
+                            const QSize &canvasSize, ColorMapObject *screenMap, ColorMapObject *localMap)
+{
+    GifStream::Screen screen = {canvasSize.width(), canvasSize.height(), 0, screenMap};
+    std::string block = GifStream::frame(screen, image.constBits(), image.bytesPerLine(),
+                                         offset.x(), offset.y(), image.width(), image.height(),
+                                         gcbBlock, localMap);
+    GifFreeMapObject(screenMap);
+    GifFreeMapObject(localMap);
+    return QByteArray(block.data(), int(block.size()));
+}
 }
 
 QGifImagePrivate::QGifImagePrivate(QGifImage *p)
-    : loopCount(0), defaultDelayTime(1000), q_ptr(p)
+    : loopCount(0), defaultDelayTime(1000), streamDevice(0)
+    , streamHeaderWritten(false), streamFailed(false), q_ptr(p)
 {
 
 }
 
 QGifImagePrivate::~QGifImagePrivate()
 {
-
+    if (streamDevice)
+        closeStream();
 }
 
 QVector<QRgb> QGifImagePrivate::colorTableFromColorMapObject(ColorMapObject *colorMap, int transColorIndex) const
@@ -223,6 +244,17 @@ bool QGifImagePrivate::load(QIODevice *device)
     return true;
 }
 
+QImage QGifImagePrivate::toIndexedImage(const QImage &image) const
+{
+    if (image.format() == QImage::Format_Indexed8)
+        return image;
+    if (quantizer)
+        return quantizer(image);
+    if (!globalColorTable.isEmpty())
+        return image.convertToFormat(QImage::Format_Indexed8, globalColorTable);
+    return image.convertToFormat(QImage::Format_Indexed8);
+}
+
 bool QGifImagePrivate::save(QIODevice *device) const
 {
     int error;
@@ -246,13 +278,7 @@ bool QGifImagePrivate::save(QIODevice *device) const
     gifFile->SavedImages = (SavedImage *)calloc(frameInfos.size(), sizeof(SavedImage));
     for (int idx=0; idx < frameInfos.size(); ++idx) {
         const QGifFrameInfoData frameInfo = frameInfos.at(idx);
-        QImage image = frameInfo.image;
-        if (image.format() != QImage::Format_Indexed8) {
-            if (!globalColorTable.isEmpty())
-                image = image.convertToFormat(QImage::Format_Indexed8, globalColorTable);
-            else
-                image = image.convertToFormat(QImage::Format_Indexed8);
-        }
+        QImage image = toIndexedImage(frameInfo.image);
 
         SavedImage *gifImage = gifFile->SavedImages + idx;
 
@@ -304,6 +330,104 @@ bool QGifImagePrivate::save(QIODevice *device) const
     return true;
 }
 
+bool QGifImagePrivate::openStream(QIODevice *device)
+{
+    streamDevice = device;
+    streamHeaderWritten = false;
+    streamFailed = false;
+    return true;
+}
+
+bool QGifImagePrivate::writeStreamHeader(const QSize &size)
+{
+    streamCanvasSize = QSize(qMax(size.width(), 0), qMax(size.height(), 0));
+    ColorMapObject *cmap = colorTableToColorMapObject(globalColorTable);
+    int bgIndex = cmap ? globalColorTable.indexOf(bgColor.rgba()) : -1;
+    GifStream::Screen screen = {streamCanvasSize.width(), streamCanvasSize.height(),
+                                bgIndex == -1 ? 0 : bgIndex, cmap};
+    std::string header = GifStream::header(screen, loopCount);
+    GifFreeMapObject(cmap);
+    if (header.empty() || streamDevice->write(header.data(), header.size()) != qint64(header.size()))
+        return false;
+
+    streamHeaderWritten = true;
+    return true;
+}
+
+bool QGifImagePrivate::writeStreamFrame(const QGifFrameInfoData &frameInfo)
+{
+    if (streamFailed)
+        return false;
+
+    QGifFrameInfoData info = frameInfo;
+    info.image = toIndexedImage(frameInfo.image);
+    const QImage image = info.image;
+
+    if (!streamHeaderWritten) {
+        QSize size = canvasSize.isValid() ? canvasSize
+                                          : QSize(image.width() + info.offset.x(),
+                                                  image.height() + info.offset.y());
+        if (!writeStreamHeader(size))
+            return false;
+    }
+
+    //Frames are drawn over the previous ones, so a frame may cover only the
+    //changed part of the canvas and leave unchanged pixels transparent.
+    GraphicsControlBlock gcbBlock;
+    gcbBlock.DisposalMode = DISPOSE_DO_NOT;
+    gcbBlock.UserInputFlag = false;
+    gcbBlock.TransparentColor = getFrameTransparentColorIndex(info);
+    gcbBlock.DelayTime = (info.delayTime != -1 ? info.delayTime : defaultDelayTime) / 10;
+
+    ColorMapObject *screenMap = colorTableToColorMapObject(globalColorTable);
+    ColorMapObject *localMap = 0;
+    if (!image.colorTable().isEmpty() && (image.colorTable() != globalColorTable))
+        localMap = colorTableToColorMapObject(image.colorTable());
+    QPoint offset = info.offset;
+    QSize size = streamCanvasSize;
+    streamPending.append(QtConcurrent::run([=]() {
+        return encodeFrameBlock(image, offset, gcbBlock, size, screenMap, localMap);
+    }));
+
+    return writeStreamBlocks(qMax(QThread::idealThreadCount(), 1) * 2);
+}
+
+bool QGifImagePrivate::writeStreamBlocks(int maxPending)
+{
+    bool written = false;
+    while (!streamPending.isEmpty()
+           && (streamPending.size() > maxPending || streamPending.first().isFinished())) {
+        QByteArray block = streamPending.takeFirst().result();
+        //Blocks after a lost one would be drawn over the wrong canvas, so
+        //they are only waited for and dropped.
+        if (streamFailed)
+            continue;
+        if (block.isEmpty() || streamDevice->write(block) != block.size())
+            streamFailed = true;
+        written = true;
+    }
+
+    if (written) {
+        if (QFileDevice *file = qobject_cast<QFileDevice *>(streamDevice))
+            file->flush();
+    }
+    return !streamFailed;
+}
+
+bool QGifImagePrivate::closeStream()
+{
+    bool ok = writeStreamBlocks(0);
+    //A stream without frames is still a valid gif file.
+    ok = (streamHeaderWritten || writeStreamHeader(canvasSize)) && ok;
+    if (streamDevice->write(&GifStream::Trailer, 1) != 1)
+        ok = false;
+    streamDevice = 0;
+    if (streamOwnedFile) {
+        streamOwnedFile->close();
+        streamOwnedFile.reset();
+    }
+    return ok;
+}
 
 /*!
     \class QGifImage
@@ -445,6 +569,32 @@ void QGifImage::setLoopCount(int loop)
     d->loopCount = loop;
 }
 
+/*!
+    Returns the function used to convert frames to the QImage::Format_Indexed8
+    format, or an empty function if QImage::convertToFormat() is used.
+
+    \sa setQuantizer()
+*/
+QGifImage::Quantizer QGifImage::quantizer() const
+{
+    Q_D(const QGifImage);
+    return d->quantizer;
+}
+
+/*!
+    Sets the function used to convert frames that are not in the
+    QImage::Format_Indexed8 format by save() and writeFrame() to \a quantizer.
+    The function receives the frame and returns its indexed version; if its
+    color table equals the global color table, no local color table is
+    written for the frame. An empty function restores the default conversion
+    by QImage::convertToFormat().
+*/
+void QGifImage::setQuantizer(const Quantizer &quantizer)
+{
+    Q_D(QGifImage);
+    d->quantizer = quantizer;
+}
+
 /*!
     Insert the QImage object \a frame at position \a index with \a delay.
 
@@ -676,3 +826,106 @@ bool QGifImage::load(QIODevice *device)
 
     return false;
 }
+
+/*!
+    Opens \a device for incremental writing. Frames passed to writeFrame()
+    are encoded and written to the device immediately instead of being kept
+    in memory, so the memory used does not grow with the number of frames.
+    The global color table, loop count, default delay and canvas size must be
+    set before the first frame is written; if the canvas size is not set, the
+    size of the first frame is used. Returns \c false if a stream is already
+    open or the device cannot be written.
+
+    Frames are converted to the QImage::Format_Indexed8 format on the calling
+    thread and LZW-compressed on QThreadPool::globalInstance(), several frames
+    at a time; the compressed frames are written to the device in the order
+    they were passed. writeFrame() waits only when twice
+    QThread::idealThreadCount() frames are still being compressed.
+
+    \sa writeFrame(), close()
+*/
+bool QGifImage::open(QIODevice *device)
+{
+    Q_D(QGifImage);
+    if (d->streamDevice || !device->isWritable())
+        return false;
+    return d->openStream(device);
+}
+
+/*!
+    \overload
+
+    Opens the file with the given \a fileName for incremental writing. The file
+    is closed by close().
+*/
+bool QGifImage::open(const QString &fileName)
+{
+    Q_D(QGifImage);
+    if (d->streamDevice)
+        return false;
+    d->streamOwnedFile.reset(new QFile(fileName));
+    if (!d->streamOwnedFile->open(QIODevice::WriteOnly) || !d->openStream(d->streamOwnedFile.data())) {
+        d->streamOwnedFile.reset();
+        return false;
+    }
+    return true;
+}
+
+/*!
+    Returns \c true if the gif image is open for incremental writing.
+*/
+bool QGifImage::isOpen() const
+{
+    Q_D(const QGifImage);
+    return d->streamDevice != 0;
+}
+
+/*!
+    Encodes the QImage object \a frame with \a delay and writes it to the
+    device passed to open(). The frame is converted to the
+    QImage::Format_Indexed8 format in the same way as in save().
+
+    QImage::offset() will be used as the position of the frame on the canvas.
+
+    Returns \c false if the stream is not open or this or an earlier frame
+    could not be written.
+*/
+bool QGifImage::writeFrame(const QImage &frame, int delay)
+{
+    return writeFrame(frame, frame.offset(), delay);
+}
+
+/*!
+    \overload
+    Encodes the QImage object \a frame with the given \a offset and \a delay and
+    writes it to the device passed to open().
+
+    Written frames are left in place when the next frame is drawn, so a frame
+    may contain only the part of the canvas that changed since the previous
+    one, with the unchanged pixels set to the transparent color.
+ */
+bool QGifImage::writeFrame(const QImage &frame, const QPoint &offset, int delay)
+{
+    Q_D(QGifImage);
+    if (!d->streamDevice)
+        return false;
+
+    QGifFrameInfoData data;
+    data.image = frame;
+    data.delayTime = delay;
+    data.offset = offset;
+    return d->writeStreamFrame(data);
+}
+
+/*!
+    Waits for the frames being compressed, writes them and the gif trailer and
+    finishes incremental writing started by open(). Returns \c false if the
+    stream was not open or any frame could not be written.
+*/
+bool QGifImage::close()
+{
+    Q_D(QGifImage);
+    if (!d->streamDevice)
+        return false;
+    return d->closeStream();
+}
@@ -30,12 +30,15 @@
 #include <QColor>
 #include <QList>
 #include <QVector>
+#include <functional>
 
 class QGifImagePrivate;
 class Q_GIFIMAGE_EXPORT QGifImage
 {
     Q_DECLARE_PRIVATE(QGifImage)
 public:
+    typedef std::function<QImage (const QImage &)> Quantizer;
+
     QGifImage();
     QGifImage(const QString &fileName);
     QGifImage(const QSize &size);
@@ -52,6 +55,9 @@ public:
     int loopCount() const;
     void setLoopCount(int loop);
 
+    Quantizer quantizer() const;
+    void setQuantizer(const Quantizer &quantizer);
+
     int frameCount() const;
     QImage frame(int index) const;
 
@@ -72,6 +78,13 @@ public:
     bool save(QIODevice *device) const;
     bool save(const QString &fileName) const;
 
+    bool open(QIODevice *device);
+    bool open(const QString &fileName);
+    bool isOpen() const;
+    bool writeFrame(const QImage &frame, int delay=-1);
+    bool writeFrame(const QImage &frame, const QPoint &offset, int delay=-1);
+    bool close();
+
 private:
     QGifImagePrivate * const d_ptr;
 };
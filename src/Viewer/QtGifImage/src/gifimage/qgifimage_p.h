@@ -30,6 +30,10 @@
 
 #include <QVector>
 #include <QColor>
+#include <QFile>
+#include <QFuture>
+#include <QList>
+#include <QScopedPointer>
 
 class QGifFrameInfoData
 {
@@ -58,6 +62,13 @@ public:
     ColorMapObject * colorTableToColorMapObject(QVector<QRgb> colorTable) const;
     QSize getCanvasSize() const;
     int getFrameTransparentColorIndex(const QGifFrameInfoData &info) const;
+    QImage toIndexedImage(const QImage &image) const;
+
+    bool openStream(QIODevice *device);
+    bool writeStreamHeader(const QSize &size);
+    bool writeStreamFrame(const QGifFrameInfoData &frameInfo);
+    bool writeStreamBlocks(int maxPending);
+    bool closeStream();
 
     QSize canvasSize;
     int loopCount;
@@ -67,6 +78,17 @@ public:
     QVector<QRgb> globalColorTable;
     QColor bgColor;
     QList<QGifFrameInfoData> frameInfos;
+    QGifImage::Quantizer quantizer;
+
+    //Incremental writer state, see QGifImage::open(). The header, frame
+    //blocks and trailer are encoded by GifStream and written to streamDevice.
+    QIODevice *streamDevice;
+    QSize streamCanvasSize;
+    QScopedPointer<QFile> streamOwnedFile;
+    bool streamHeaderWritten;
+    //Frames being compressed on the global thread pool, in stream order
+    QList<QFuture<QByteArray> > streamPending;
+    bool streamFailed;
 
     QGifImage *q_ptr;
 };
@@ -1,7 +1,7 @@
 INCLUDEPATH += $$PWD
 DEPENDPATH += $$PWD
 
-QT += core gui
+QT += core gui concurrent
 !build_gifimage_lib:DEFINES += GIFIMAGE_NO_LIB
 
 include($$PWD/../3rdParty/giflib.pri)
@@ -9,7 +9,9 @@ include($$PWD/../3rdParty/giflib.pri)
 HEADERS += \
     $$PWD/qgifglobal.h \
     $$PWD/qgifimage.h \
-    $$PWD/qgifimage_p.h
+    $$PWD/qgifimage_p.h \
+    $$PWD/gifstream.h
 
 SOURCES += \ 
-    $$PWD/qgifimage.cpp
+    $$PWD/qgifimage.cpp \
+    $$PWD/gifstream.cpp
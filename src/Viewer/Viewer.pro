@@ -12,19 +12,46 @@ include(QtGifImage/src/gifimage/qtgifimage.pri)
 
 SOURCES += \
     model.cc \
+    mapped_file.cc \
+    decompressor.cc \
+    mesh_cache.cc \
+    thread_pool.cc \
     view.cc \
     affine.cc \
+    transform_kernels.cc \
+    gif_recorder.cc \
+    color_quantizer.cc \
+    frame_delta.cc \
     main.cc
 
 HEADERS += \
     model.h \
+    mapped_file.h \
+    decompressor.h \
+    mesh_cache.h \
+    vertex_buffer.h \
+    thread_pool.h \
     view.h \
     affine.h \
+    transform_matrix.h \
+    transform_kernels.h \
+    render_settings.h \
+    bounded_queue.h \
+    gif_recorder.h \
+    color_quantizer.h \
+    frame_delta.h \
     controller.h
 
 FORMS += \
     view.ui
 
+# Сжатые модели: gzip всегда, zstd — при сборке с CONFIG+=zstd
+LIBS += -lz
+zstd {
+    DEFINES += S21_WITH_ZSTD
+    LIBS += -lzstd
+}
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
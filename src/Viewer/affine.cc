@@ -1,12 +1,47 @@
 #include "affine.h"
 
+/**
+ * @brief Сворачивает данные преобразования в одну матрицу.
+ *
+ * Каждая следующая операция умножается слева, так что итоговая матрица
+ * равна S * Rz * Ry * Rx * T. Синусы и косинусы углов вычисляются один раз на
+ * преобразование, а не на каждую вершину. Неположительный коэффициент
+ * масштабирования игнорируется, как и в scaling().
+ *
+ * @param transform_data Матрица данных в формате affineTransform().
+ * @return Итоговая матрица преобразования.
+ */
+s21::TransformMatrix s21::Affine::composeTransform(
+    double transform_data[3][3]) noexcept {
+  TransformMatrix matrix = TransformMatrix::translation(
+      transform_data[0][0], transform_data[0][1], transform_data[0][2]);
+  matrix = TransformMatrix::rotationX(transform_data[1][0]) * matrix;
+  matrix = TransformMatrix::rotationY(transform_data[1][1]) * matrix;
+  matrix = TransformMatrix::rotationZ(transform_data[1][2]) * matrix;
+  if (transform_data[2][0] > 0)
+    matrix = TransformMatrix::scaling(transform_data[2][0]) * matrix;
+  return matrix;
+}
+
+/**
+ * @brief Добавляет преобразование к матрице модели.
+ *
+ * Вершины модели не изменяются: преобразование умножается слева на
+ * накопленную матрицу модели, поэтому стоимость операции не зависит от
+ * размера модели, а ошибка округления не накапливается в координатах.
+ *
+ * @param matrix Матрица аффинного преобразования.
+ */
+void s21::Affine::transform(const TransformMatrix &matrix) noexcept {
+  model.viewer.matrix = matrix * model.viewer.matrix;
+}
+
 /**
  * @brief Сдвигает все вершины модели вдоль оси X на заданное расстояние.
  * @param a Расстояние для сдвига.
  */
 void s21::Affine::movingX(double a) noexcept {
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i)
-    model.viewer.matrix_of_vertexes.matrix[i][0] += a;
+  transform(TransformMatrix::translation(a, 0, 0));
 }
 
 /**
@@ -14,8 +49,7 @@ void s21::Affine::movingX(double a) noexcept {
  * @param a Расстояние для сдвига.
  */
 void s21::Affine::movingY(double a) noexcept {
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i)
-    model.viewer.matrix_of_vertexes.matrix[i][1] += a;
+  transform(TransformMatrix::translation(0, a, 0));
 }
 
 /**
@@ -23,8 +57,7 @@ void s21::Affine::movingY(double a) noexcept {
  * @param a Расстояние для сдвига.
  */
 void s21::Affine::movingZ(double a) noexcept {
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i)
-    model.viewer.matrix_of_vertexes.matrix[i][2] += a;
+  transform(TransformMatrix::translation(0, 0, a));
 }
 
 /**
@@ -32,14 +65,7 @@ void s21::Affine::movingZ(double a) noexcept {
  * @param a Угол поворота в радианах.
  */
 void s21::Affine::rotationX(double a) noexcept {
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    double temp_y = model.viewer.matrix_of_vertexes.matrix[i][1];
-    double temp_z = model.viewer.matrix_of_vertexes.matrix[i][2];
-    model.viewer.matrix_of_vertexes.matrix[i][1] =
-        cos(a) * temp_y - sin(a) * temp_z;
-    model.viewer.matrix_of_vertexes.matrix[i][2] =
-        sin(a) * temp_y + cos(a) * temp_z;
-  }
+  transform(TransformMatrix::rotationX(a));
 }
 
 /**
@@ -47,14 +73,7 @@ void s21::Affine::rotationX(double a) noexcept {
  * @param a Угол поворота в радианах.
  */
 void s21::Affine::rotationY(double a) noexcept {
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    double temp_x = model.viewer.matrix_of_vertexes.matrix[i][0];
-    double temp_z = model.viewer.matrix_of_vertexes.matrix[i][2];
-    model.viewer.matrix_of_vertexes.matrix[i][0] =
-        cos(a) * temp_x + sin(a) * temp_z;
-    model.viewer.matrix_of_vertexes.matrix[i][2] =
-        -sin(a) * temp_x + cos(a) * temp_z;
-  }
+  transform(TransformMatrix::rotationY(a));
 }
 
 /**
@@ -62,14 +81,7 @@ void s21::Affine::rotationY(double a) noexcept {
  * @param a Угол поворота в радианах.
  */
 void s21::Affine::rotationZ(double a) noexcept {
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    double temp_x = model.viewer.matrix_of_vertexes.matrix[i][0];
-    double temp_y = model.viewer.matrix_of_vertexes.matrix[i][1];
-    model.viewer.matrix_of_vertexes.matrix[i][0] =
-        cos(a) * temp_x - sin(a) * temp_y;
-    model.viewer.matrix_of_vertexes.matrix[i][1] =
-        sin(a) * temp_x + cos(a) * temp_y;
-  }
+  transform(TransformMatrix::rotationZ(a));
 }
 
 /**
@@ -78,8 +90,5 @@ void s21::Affine::rotationZ(double a) noexcept {
  * @note Если a > 0, модель увеличится, иначе уменьшится.
  */
 void s21::Affine::scaling(double a) noexcept {
-  if (a > 0)
-    for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i)
-      for (unsigned int j = 0; j < model.viewer.matrix_of_vertexes.columns; ++j)
-        model.viewer.matrix_of_vertexes.matrix[i][j] *= a;
+  if (a > 0) transform(TransformMatrix::scaling(a));
 }
@@ -8,6 +8,7 @@
 #define CPP4_3DVIEWER_V2_VIEWER_AFFINE_H_
 
 #include "model.h"
+#include "transform_matrix.h"
 
 /**
  * @brief Пространство имён s21 содержит класс Аffine, View,
@@ -17,6 +18,9 @@
 namespace s21 {
 /**
  * @brief Класс для аффинных преобразований трехмерных моделей.
+ *
+ * Все операции выполняются за O(1): они изменяют только матрицу модели, а
+ * загруженная геометрия остаётся неизменной.
  */
 class Affine {
  public:
@@ -26,19 +30,30 @@ class Affine {
    *                      Первый столбец - сдвиги по осям X, Y и Z.
    *                      Второй столбец - углы поворота вокруг осей X, Y и Z (в
    * радианах). Третий столбец - коэффициент масштабирования.
-   * @note Функция последовательно применяет сдвиги, повороты и масштабирование
-   * к модели.
+   * @note Сдвиги, повороты и масштабирование сворачиваются в одну матрицу
+   * (в этом порядке применения), которая добавляется к матрице модели.
    */
   inline void affineTransform(double transform_data[3][3]) noexcept {
-    movingX(transform_data[0][0]);
-    movingY(transform_data[0][1]);
-    movingZ(transform_data[0][2]);
-    rotationX(transform_data[1][0]);
-    rotationY(transform_data[1][1]);
-    rotationZ(transform_data[1][2]);
-    scaling(transform_data[2][0]);
+    transform(composeTransform(transform_data));
   }
 
+  /**
+   * @brief Сворачивает данные преобразования в одну матрицу.
+   * @param transform_data Матрица данных в формате affineTransform().
+   * @return Матрица, эквивалентная последовательному применению сдвигов по
+   * X, Y и Z, поворотов вокруг X, Y и Z и масштабирования.
+   */
+  static TransformMatrix composeTransform(
+      double transform_data[3][3]) noexcept;
+
+  /**
+   * @brief Добавляет преобразование к матрице модели.
+   * @param matrix Матрица аффинного преобразования.
+   * @note Загруженные вершины не изменяются; матрица модели применяется при
+   * отрисовке.
+   */
+  void transform(const TransformMatrix &matrix) noexcept;
+
   /**
    * @brief Масштабирует модель на заданный коэффициент.
    * @param a Коэффициент масштабирования.
@@ -0,0 +1,239 @@
+/*!
+\file
+\brief Консольная пакетная отрисовка моделей .obj в изображения без дисплея.
+
+Пример: ViewerBatch -o thumbs -f jpeg -s 256x256 --rotate 30,45,0 models/
+
+Анимация оборота вокруг оси Y: ViewerBatch -o turns --gif 36 models/
+*/
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QSettings>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+#include "affine.h"
+#include "gif_recorder.h"
+#include "model.h"
+#include "rasterizer.h"
+#include "render_settings.h"
+#include "thread_pool.h"
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/**
+ * @brief Ключи файла настроек, влияющие на отрисовку.
+ */
+const char *const kRenderKeys[] = {
+    "projection",  "lineType",      "lineColor",  "lineWidth",
+    "vertexColor", "vertexDisplay", "vertexSize", "backgroundColor",
+};
+
+/**
+ * @brief Разбор тройки чисел "x,y,z".
+ *
+ * @return false, если строка не содержит ровно три числа.
+ */
+bool parseTriple(const QString &text, double triple[3]) {
+  QStringList parts = text.split(',');
+  if (parts.size() != 3) return false;
+  for (int i = 0; i < 3; i++) {
+    bool ok = false;
+    triple[i] = parts[i].toDouble(&ok);
+    if (!ok) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Сбор файлов .obj из списка файлов и каталогов.
+ */
+QStringList collectInputs(const QStringList &paths) {
+  QStringList files;
+  for (const QString &path : paths) {
+    QFileInfo info(path);
+    if (info.isDir()) {
+      QDir dir(path);
+      for (const QString &name :
+           dir.entryList({"*.obj"}, QDir::Files, QDir::Name))
+        files << dir.filePath(name);
+    } else {
+      files << path;
+    }
+  }
+  return files;
+}
+
+/**
+ * @brief Запись анимации полного оборота модели вокруг оси Y.
+ *
+ * Кадр f отрисовывается с поворотом центрированной модели на
+ * 360° * f / frames вокруг её оси Y, после которого применяется
+ * преобразование transform. Растеризатор переиспользует свой буфер, поэтому
+ * в GifRecorder передаётся копия кадра; pushFrame() ждёт кодировщик, и
+ * кадры не пропускаются.
+ *
+ * @return false, если файл анимации не удалось открыть.
+ */
+bool writeTurntable(const QString &target, const s21::Model::Data &data,
+                    const s21::RenderSettings &render,
+                    const s21::TransformMatrix &transform, int width,
+                    int height, int frames, int delay) {
+  s21::GifRecorder recorder(target, delay);
+  if (!recorder.isOpen()) return false;
+  const s21::TransformMatrix centering = s21::Model::centering(data);
+  s21::Rasterizer rasterizer(width, height);
+  for (int f = 0; f < frames; f++) {
+    const double angle = 2 * kPi * f / frames;
+    rasterizer.render(
+        data, render, s21::TransformMatrix::identity(),
+        transform * s21::TransformMatrix::rotationY(angle) * centering);
+    recorder.pushFrame(
+        QImage(reinterpret_cast<const uchar *>(rasterizer.pixels()),
+               rasterizer.width(), rasterizer.height(), QImage::Format_ARGB32)
+            .copy());
+  }
+  return true;
+}
+
+}  // namespace
+
+/**
+ * @brief Точка входа консольной отрисовки.
+ *
+ * Каждый файл загружается парсером Model в собственные данные, центрируется
+ * как в окне просмотра, преобразуется заданными сдвигом, поворотом и
+ * масштабом, отрисовывается программным растеризатором и сохраняется в
+ * выбранном формате. С --gif вместо изображения записывается анимация
+ * оборота модели (writeTurntable()). Файлы обрабатываются параллельно в
+ * пуле потоков.
+ *
+ * @return 0, если все файлы обработаны успешно, иначе 1.
+ */
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("ViewerBatch");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Renders .obj models to JPEG/BMP/PNG images or turntable GIFs "
+      "without a display.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("inputs", "Model files or directories.",
+                               "<file.obj|dir>...");
+  QCommandLineOption output({"o", "output"}, "Output directory.", "dir", ".");
+  QCommandLineOption format({"f", "format"}, "png, jpeg or bmp.", "format",
+                            "png");
+  QCommandLineOption size({"s", "size"}, "Image size.", "WxH", "800x800");
+  QCommandLineOption settings({"c", "settings"}, "Render settings file.",
+                              "file", "launch_settings.init");
+  QCommandLineOption move("move", "Translation.", "x,y,z", "0,0,0");
+  QCommandLineOption rotate("rotate", "Rotation in degrees.", "x,y,z",
+                            "0,0,0");
+  QCommandLineOption scale("scale", "Scale factor.", "k", "1");
+  QCommandLineOption gif("gif",
+                         "Write a GIF of a full turn about the Y axis in N "
+                         "frames instead of an image.",
+                         "N");
+  QCommandLineOption delay("delay", "GIF frame delay in milliseconds.", "ms",
+                           "100");
+  parser.addOptions(
+      {output, format, size, settings, move, rotate, scale, gif, delay});
+  parser.process(app);
+
+  QStringList files = collectInputs(parser.positionalArguments());
+  if (files.isEmpty()) parser.showHelp(1);
+
+  const bool turntable = parser.isSet(gif);
+  int frames = 0, frame_delay = 0;
+  if (turntable) {
+    bool frames_ok = false, delay_ok = false;
+    frames = parser.value(gif).toInt(&frames_ok);
+    frame_delay = parser.value(delay).toInt(&delay_ok);
+    if (!frames_ok || frames <= 0 || !delay_ok || frame_delay < 0) {
+      std::fprintf(stderr, "Invalid GIF frame count or delay\n");
+      return 1;
+    }
+  }
+
+  QString suffix = turntable ? "gif" : parser.value(format).toLower();
+  if (!turntable && suffix != "png" && suffix != "jpeg" && suffix != "jpg" &&
+      suffix != "bmp") {
+    std::fprintf(stderr, "Unsupported format: %s\n", qPrintable(suffix));
+    return 1;
+  }
+
+  QStringList dimensions = parser.value(size).split('x');
+  int width = dimensions.value(0).toInt(), height = dimensions.value(1).toInt();
+  double transform_data[3][3] = {};
+  bool scale_ok = false;
+  transform_data[2][0] = parser.value(scale).toDouble(&scale_ok);
+  if (dimensions.size() != 2 || width <= 0 || height <= 0 || !scale_ok ||
+      !parseTriple(parser.value(move), transform_data[0]) ||
+      !parseTriple(parser.value(rotate), transform_data[1])) {
+    std::fprintf(stderr, "Invalid size or transform arguments\n");
+    return 1;
+  }
+  for (double &angle : transform_data[1]) angle *= kPi / 180;
+  const s21::TransformMatrix transform =
+      s21::Affine::composeTransform(transform_data);
+
+  s21::RenderSettings render;
+  QSettings stored(parser.value(settings), QSettings::IniFormat);
+  for (const char *key : kRenderKeys)
+    render.set(key, stored.value(key).toString().toStdString());
+
+  QDir output_dir(parser.value(output));
+  if (!output_dir.mkpath(".")) {
+    std::fprintf(stderr, "Cannot create %s\n", qPrintable(output_dir.path()));
+    return 1;
+  }
+
+  // Каждый файл разбирается в одном потоке, если файлов хватает на все ядра;
+  // иначе файл дополнительно делится на части.
+  s21::ThreadPool &pool = s21::ThreadPool::getInstance();
+  unsigned int parser_threads =
+      static_cast<unsigned int>(files.size()) >= pool.concurrency() ? 1 : 0;
+  std::atomic<int> failures{0};
+  pool.parallelFor(files.size(), [&](std::size_t i) {
+    const QString &file = files[static_cast<int>(i)];
+    s21::Model::Data data;
+    QByteArray path = QFile::encodeName(file);
+    if (!s21::Model::parseFile(path.constData(), data, parser_threads)) {
+      std::fprintf(stderr, "Cannot open %s\n", qPrintable(file));
+      failures++;
+      return;
+    }
+
+    QString target =
+        output_dir.filePath(QFileInfo(file).completeBaseName() + "." + suffix);
+    if (turntable) {
+      if (!writeTurntable(target, data, render, transform, width, height,
+                          frames, frame_delay)) {
+        std::fprintf(stderr, "Cannot write %s\n", qPrintable(target));
+        failures++;
+      }
+      return;
+    }
+
+    s21::Rasterizer rasterizer(width, height);
+    rasterizer.render(data, render, s21::TransformMatrix::identity(),
+                      transform * s21::Model::centering(data));
+    QImage image(reinterpret_cast<const uchar *>(rasterizer.pixels()),
+                 rasterizer.width(), rasterizer.height(),
+                 QImage::Format_ARGB32);
+    if (!image.save(target, nullptr, 100)) {
+      std::fprintf(stderr, "Cannot write %s\n", qPrintable(target));
+      failures++;
+    }
+  });
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением шаблона BoundedQueue — очереди
+ограниченного размера для передачи данных между потоками.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_BOUNDED_QUEUE_H_
+#define CPP4_3DVIEWER_V2_VIEWER_BOUNDED_QUEUE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace s21 {
+
+/**
+ * @brief Очередь ограниченного размера «производитель — потребитель».
+ *
+ * push() ждёт, пока в заполненной очереди не освободится место, поэтому
+ * медленный потребитель притормаживает производителя, а не копит данные
+ * без ограничения. Производитель, которому нельзя ждать, вызывает
+ * tryPush() и сам решает, что делать с непринятым элементом. После close()
+ * новые элементы не принимаются, а pop() отдаёт оставшиеся и затем сообщает
+ * о конце очереди.
+ *
+ * @tparam T Тип элементов.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  /**
+   * @brief Создание очереди.
+   *
+   * @param capacity Наибольшее количество элементов (не меньше 1).
+   */
+  explicit BoundedQueue(std::size_t capacity)
+      : capacity(capacity ? capacity : 1) {}
+
+  BoundedQueue(const BoundedQueue &other) = delete;
+  void operator=(const BoundedQueue &other) = delete;
+
+  /**
+   * @brief Добавление элемента в конец очереди.
+   *
+   * @param item Элемент.
+   * @return false, если очередь закрыта и элемент не добавлен.
+   */
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_full.wait(lock, [this] { return closed || items.size() < capacity; });
+    if (closed) return false;
+    items.push_back(std::move(item));
+    lock.unlock();
+    not_empty.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Добавление элемента в конец очереди без ожидания.
+   *
+   * @param item Элемент.
+   * @return false, если очередь закрыта или заполнена и элемент не добавлен.
+   */
+  bool tryPush(T item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (closed || items.size() >= capacity) return false;
+    items.push_back(std::move(item));
+    lock.unlock();
+    not_empty.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Извлечение элемента из начала очереди.
+   *
+   * @param[out] item Извлечённый элемент.
+   * @return false, если очередь закрыта и пуста.
+   */
+  bool pop(T &item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_empty.wait(lock, [this] { return closed || !items.empty(); });
+    if (items.empty()) return false;
+    item = std::move(items.front());
+    items.pop_front();
+    lock.unlock();
+    not_full.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Закрытие очереди и пробуждение всех ожидающих потоков.
+   */
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      closed = true;
+    }
+    not_full.notify_all();
+    not_empty.notify_all();
+  }
+
+ private:
+  const std::size_t capacity;          ///< Наибольший размер очереди.
+  std::deque<T> items;                 ///< Элементы очереди.
+  bool closed = false;                 ///< Закрыта ли очередь.
+  std::mutex mutex;                    ///< Защита очереди.
+  std::condition_variable not_full;    ///< Появилось место.
+  std::condition_variable not_empty;   ///< Появился элемент.
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_BOUNDED_QUEUE_H_
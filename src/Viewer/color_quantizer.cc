@@ -0,0 +1,296 @@
+#include "color_quantizer.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+/**
+ * @brief Пороговая матрица Байера 4x4.
+ */
+constexpr int kBayer[4][4] = {
+    {0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+/**
+ * @brief Количество листьев, при превышении которого дерево сокращается
+ * ещё во время построения; ограничивает память на кадрах с большим
+ * количеством цветов.
+ */
+constexpr int kMaxLeaves = 1 << 12;
+
+}  // namespace
+
+/**
+ * @brief Создание квантователя без палитры.
+ *
+ * @param max_colors Наибольший размер палитры (от 1 до kMaxColors).
+ * @param dither Способ дизеринга.
+ */
+s21::ColorQuantizer::ColorQuantizer(int max_colors, Dither dither)
+    : max_colors(std::clamp(max_colors, 1, kMaxColors)), dither(dither) {}
+
+/**
+ * @brief Построение палитры по изображению.
+ *
+ * Подряд идущие одинаковые пиксели добавляются одной операцией. Если
+ * листьев становится больше kMaxLeaves, последний добавленный узел самого
+ * глубокого уровня сразу сливается в лист; после добавления всех пикселей
+ * дерево сокращается до max_colors, начиная с самого глубокого уровня и с
+ * наименьшего числа пикселей, поэтому редкие оттенки объединяются раньше
+ * заметных цветов.
+ */
+void s21::ColorQuantizer::buildPalette(const uint32_t *pixels, int width,
+                                       int height, std::size_t stride) {
+  std::vector<Node> tree(1);
+  tree.reserve(1024);
+  std::vector<int32_t> levels[kDepth];
+  levels[0].push_back(0);
+  int leaves = 0;
+
+  // Слияние узла с поддеревом в один лист
+  auto merge = [&tree](int32_t root) {
+    int removed = -1;
+    std::vector<int32_t> stack{root};
+    while (!stack.empty()) {
+      Node &node = tree[stack.back()];
+      stack.pop_back();
+      if (node.leaf) {
+        removed++;
+        continue;
+      }
+      node.leaf = true;
+      for (int32_t child : node.children)
+        if (child >= 0) stack.push_back(child);
+    }
+    tree[root].leaf = true;
+    return removed;
+  };
+  // Сокращение до target листьев; sorted — сливать сначала узлы с
+  // наименьшим числом пикселей, иначе — последние добавленные
+  auto reduce = [&](int target, bool sorted) {
+    for (int level = kDepth - 1; level >= 0 && leaves > target; level--) {
+      std::vector<int32_t> &list = levels[level];
+      if (sorted)
+        std::sort(list.begin(), list.end(), [&tree](int32_t a, int32_t b) {
+          return tree[a].count > tree[b].count;
+        });
+      while (!list.empty() && leaves > target) {
+        int32_t node = list.back();
+        list.pop_back();
+        if (!tree[node].leaf) leaves -= merge(node);
+      }
+    }
+  };
+
+  for (int y = 0; y < height; y++) {
+    const uint32_t *row = pixels + y * stride;
+    for (int x = 0; x < width;) {
+      uint32_t rgb = row[x] & 0xFFFFFF;
+      int run = 1;
+      while (x + run < width && (row[x + run] & 0xFFFFFF) == rgb) run++;
+      insert(tree, levels, rgb, run, leaves);
+      if (leaves > kMaxLeaves) reduce(kMaxLeaves, false);
+      x += run;
+    }
+  }
+  reduce(max_colors, true);
+
+  colors.clear();
+  std::vector<int32_t> stack{0};
+  while (!stack.empty()) {
+    const Node &node = tree[stack.back()];
+    stack.pop_back();
+    if (node.leaf) {
+      uint64_t n = std::max<uint64_t>(node.count, 1);
+      colors.push_back(0xFF000000u |
+                       static_cast<uint32_t>((node.red + n / 2) / n) << 16 |
+                       static_cast<uint32_t>((node.green + n / 2) / n) << 8 |
+                       static_cast<uint32_t>((node.blue + n / 2) / n));
+      continue;
+    }
+    for (int i = 7; i >= 0; i--)
+      if (node.children[i] >= 0) stack.push_back(node.children[i]);
+  }
+  by_green.resize(colors.size());
+  for (std::size_t i = 0; i < colors.size(); i++)
+    by_green[i] = static_cast<uint8_t>(i);
+  std::sort(by_green.begin(), by_green.end(), [this](uint8_t a, uint8_t b) {
+    return (colors[a] >> 8 & 0xFF) < (colors[b] >> 8 & 0xFF);
+  });
+  table.assign(std::size_t{1} << (3 * kLookupBits), -1);
+}
+
+/**
+ * @brief Непрозрачный цвет, которого нет в палитре.
+ *
+ * Цвета перебираются начиная с чёрного; в палитре не больше kMaxColors
+ * цветов, поэтому свободный находится не более чем за kMaxColors + 1 шагов.
+ */
+uint32_t s21::ColorQuantizer::unusedColor() const noexcept {
+  uint32_t color = 0xFF000000u;
+  while (std::find(colors.begin(), colors.end(), color) != colors.end())
+    color++;
+  return color;
+}
+
+/**
+ * @brief Перевод изображения в индексы текущей палитры.
+ *
+ * Без дизеринга индекс повторяющегося пикселя берётся от предыдущего.
+ * Неизменившиеся пиксели заменяются индексом transparent уже после перевода
+ * строки, чтобы не усложнять основной цикл.
+ */
+void s21::ColorQuantizer::map(const uint32_t *pixels, int width, int height,
+                              std::size_t stride, uint8_t *indexes,
+                              std::size_t index_stride,
+                              const uint32_t *previous, uint8_t transparent) {
+  if (!hasPalette()) buildPalette(pixels, width, height, stride);
+  for (int y = 0; y < height; y++) {
+    const uint32_t *row = pixels + y * stride;
+    uint8_t *out = indexes + y * index_stride;
+    mapRow(row, y, width, out);
+    if (previous == nullptr) continue;
+    const uint32_t *before = previous + y * stride;
+    for (int x = 0; x < width; x++)
+      if (row[x] == before[x]) out[x] = transparent;
+  }
+}
+
+/**
+ * @brief Перевод строки y изображения в индексы палитры.
+ */
+void s21::ColorQuantizer::mapRow(const uint32_t *row, int y, int width,
+                                 uint8_t *out) {
+  if (dither == Dither::kOrdered) {
+    for (int x = 0; x < width; x++) {
+      int offset = (2 * kBayer[y & 3][x & 3] + 1) * kDitherSpread / 32 -
+                   kDitherSpread / 2;
+      auto channel = [offset](uint32_t c) {
+        return std::clamp(static_cast<int>(c & 0xFF) + offset, 0, 255);
+      };
+      out[x] = lookup(channel(row[x] >> 16), channel(row[x] >> 8),
+                      channel(row[x]));
+    }
+    return;
+  }
+  uint32_t previous = 0;
+  uint8_t index = 0;
+  for (int x = 0; x < width; x++) {
+    uint32_t rgb = row[x] & 0xFFFFFF;
+    if (x == 0 || rgb != previous) {
+      index = lookup(rgb >> 16, rgb >> 8 & 0xFF, rgb & 0xFF);
+      previous = rgb;
+    }
+    out[x] = index;
+  }
+}
+
+/**
+ * @brief Добавление count пикселей цвета rgb в дерево.
+ *
+ * Спуск прекращается на первом листе: после сокращения дерева цвета,
+ * попавшие в слитый узел, накапливаются в нём.
+ */
+void s21::ColorQuantizer::insert(std::vector<Node> &tree,
+                                 std::vector<int32_t> levels[kDepth],
+                                 uint32_t rgb, uint64_t count,
+                                 int &leaves) {
+  const uint64_t red = rgb >> 16, green = rgb >> 8 & 0xFF, blue = rgb & 0xFF;
+  int32_t current = 0;
+  for (int level = 0;; level++) {
+    Node &node = tree[current];
+    node.count += count;
+    node.red += red * count;
+    node.green += green * count;
+    node.blue += blue * count;
+    if (node.leaf) return;
+
+    int shift = kDepth - 1 - level;
+    int child = (red >> shift & 1) << 2 | (green >> shift & 1) << 1 |
+                (blue >> shift & 1);
+    if (node.children[child] < 0) {
+      int32_t created = static_cast<int32_t>(tree.size());
+      node.children[child] = created;
+      tree.emplace_back();
+      if (level + 1 == kDepth) {
+        tree.back().leaf = true;
+        leaves++;
+      } else {
+        levels[level + 1].push_back(created);
+      }
+    }
+    current = tree[current].children[child];
+  }
+}
+
+/**
+ * @brief Индекс ближайшего по евклидову расстоянию цвета палитры.
+ *
+ * Цвета палитры упорядочены по зелёному каналу; поиск идёт от цвета с
+ * ближайшим значением зелёного в обе стороны и прекращается, когда разница
+ * одного зелёного канала уже не меньше лучшего найденного расстояния.
+ */
+int s21::ColorQuantizer::nearest(int red, int green,
+                                 int blue) const noexcept {
+  auto distance = [&](int index) {
+    int dr = static_cast<int>(colors[index] >> 16 & 0xFF) - red;
+    int dg = static_cast<int>(colors[index] >> 8 & 0xFF) - green;
+    int db = static_cast<int>(colors[index] & 0xFF) - blue;
+    return dr * dr + dg * dg + db * db;
+  };
+  auto green_of = [this](int index) {
+    return static_cast<int>(colors[index] >> 8 & 0xFF);
+  };
+  int upper = static_cast<int>(
+      std::lower_bound(by_green.begin(), by_green.end(), green,
+                       [&green_of](uint8_t index, int value) {
+                         return green_of(index) < value;
+                       }) -
+      by_green.begin());
+  int lower = upper - 1, count = static_cast<int>(by_green.size());
+  int best = by_green[upper < count ? upper : lower];
+  int best_distance = std::numeric_limits<int>::max();
+  while (lower >= 0 || upper < count) {
+    if (upper < count) {
+      int dg = green_of(by_green[upper]) - green;
+      if (dg * dg >= best_distance) {
+        upper = count;
+      } else {
+        int d = distance(by_green[upper++]);
+        if (d < best_distance) best_distance = d, best = by_green[upper - 1];
+      }
+    }
+    if (lower >= 0) {
+      int dg = green - green_of(by_green[lower]);
+      if (dg * dg >= best_distance) {
+        lower = -1;
+      } else {
+        int d = distance(by_green[lower--]);
+        if (d < best_distance) best_distance = d, best = by_green[lower + 1];
+      }
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Индекс цвета палитры через таблицу ближайших цветов.
+ *
+ * Таблица делит каждый канал на 2^kLookupBits интервалов; ближайший цвет
+ * палитры для центра интервала ищется при первом обращении.
+ */
+uint8_t s21::ColorQuantizer::lookup(int red, int green, int blue) noexcept {
+  constexpr int shift = 8 - kLookupBits;
+  std::size_t key = static_cast<std::size_t>(red >> shift)
+                        << (2 * kLookupBits) |
+                    static_cast<std::size_t>(green >> shift) << kLookupBits |
+                    static_cast<std::size_t>(blue >> shift);
+  int16_t &entry = table[key];
+  if (entry < 0) {
+    constexpr int half = 1 << shift >> 1;
+    entry = static_cast<int16_t>(nearest(red >> shift << shift | half,
+                                         green >> shift << shift | half,
+                                         blue >> shift << shift | half));
+  }
+  return static_cast<uint8_t>(entry);
+}
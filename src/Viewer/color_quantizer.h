@@ -0,0 +1,186 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением класса ColorQuantizer — построения
+палитры кадров GIF-анимации методом октодерева.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_COLOR_QUANTIZER_H_
+#define CPP4_3DVIEWER_V2_VIEWER_COLOR_QUANTIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace s21 {
+
+/**
+ * @brief Построение палитры и перевод изображения в индексы палитры.
+ *
+ * Палитра строится по всем пикселям кадра методом октодерева: каждый цвет
+ * спускается по восьми уровням дерева (по биту каждого канала на уровень),
+ * затем самые глубокие узлы с наименьшим числом пикселей сливаются, пока
+ * листьев не останется не больше max_colors. Подряд идущие одинаковые
+ * пиксели добавляются в дерево одной операцией, поэтому кадры просмотрщика
+ * с однородным фоном обрабатываются быстро.
+ *
+ * Палитра сохраняется между кадрами: все кадры анимации можно перевести в
+ * одну общую палитру, которая записывается в файл один раз. Перевод цвета в
+ * индекс выполняется через таблицу ближайших цветов палитры, заполняемую по
+ * мере обращения. По желанию добавляется упорядоченный дизеринг матрицей
+ * Байера 4x4.
+ *
+ * Пиксели передаются в формате 0xAARRGGBB (QImage::Format_ARGB32, см.
+ * Rasterizer::pixels()); прозрачность не учитывается.
+ */
+class ColorQuantizer {
+ public:
+  /**
+   * @brief Способ дизеринга.
+   */
+  enum class Dither {
+    kNone,     ///< Без дизеринга.
+    kOrdered,  ///< Упорядоченный дизеринг матрицей Байера 4x4.
+  };
+
+  /**
+   * @brief Наибольший размер палитры GIF.
+   */
+  static constexpr int kMaxColors = 256;
+
+  /**
+   * @brief Сторона матрицы упорядоченного дизеринга.
+   *
+   * Узор дизеринга зависит от положения пикселя относительно начала
+   * переводимой области, поэтому области одного холста должны начинаться с
+   * координат, кратных kDitherSize (см. alignRect()).
+   */
+  static constexpr int kDitherSize = 4;
+
+  /**
+   * @brief Создание квантователя без палитры.
+   *
+   * @param max_colors Наибольший размер палитры (от 1 до kMaxColors).
+   * @param dither Способ дизеринга.
+   */
+  explicit ColorQuantizer(int max_colors = kMaxColors,
+                          Dither dither = Dither::kNone);
+
+  /**
+   * @brief Выбор способа дизеринга.
+   */
+  inline void setDither(Dither dither) noexcept { this->dither = dither; }
+
+  /**
+   * @brief Построена ли палитра.
+   */
+  inline bool hasPalette() const noexcept { return !colors.empty(); }
+
+  /**
+   * @brief Палитра в формате 0xFFRRGGBB.
+   */
+  inline const std::vector<uint32_t> &palette() const noexcept {
+    return colors;
+  }
+
+  /**
+   * @brief Непрозрачный цвет, которого нет в палитре.
+   *
+   * Используется как прозрачный цвет анимации: декодер находит его индекс
+   * в таблице цветов однозначно.
+   */
+  uint32_t unusedColor() const noexcept;
+
+  /**
+   * @brief Построение палитры по изображению.
+   *
+   * Заменяет предыдущую палитру.
+   *
+   * @param pixels Пиксели изображения.
+   * @param width Ширина изображения.
+   * @param height Высота изображения.
+   * @param stride Расстояние между строками в пикселях.
+   */
+  void buildPalette(const uint32_t *pixels, int width, int height,
+                    std::size_t stride);
+
+  /**
+   * @brief Перевод изображения в индексы текущей палитры.
+   *
+   * Если палитра ещё не построена, она строится по этому изображению. Если
+   * передано предыдущее изображение, пиксели, не изменившиеся с него,
+   * получают индекс transparent.
+   *
+   * @param pixels Пиксели изображения.
+   * @param width Ширина изображения.
+   * @param height Высота изображения.
+   * @param stride Расстояние между строками изображения в пикселях.
+   * @param[out] indexes Индексы палитры.
+   * @param index_stride Расстояние между строками indexes в байтах.
+   * @param previous Пиксели предыдущего изображения того же размера и с тем
+   * же stride или nullptr.
+   * @param transparent Индекс для неизменившихся пикселей.
+   */
+  void map(const uint32_t *pixels, int width, int height, std::size_t stride,
+           uint8_t *indexes, std::size_t index_stride,
+           const uint32_t *previous = nullptr, uint8_t transparent = 0);
+
+ private:
+  /**
+   * @brief Количество уровней октодерева (бит на канал).
+   */
+  static constexpr int kDepth = 8;
+
+  /**
+   * @brief Бит на канал в таблице ближайших цветов.
+   */
+  static constexpr int kLookupBits = 6;
+
+  /**
+   * @brief Размах смещения цвета при дизеринге.
+   */
+  static constexpr int kDitherSpread = 32;
+
+  /**
+   * @brief Узел октодерева.
+   */
+  struct Node {
+    uint64_t count = 0;                ///< Пикселей в поддереве.
+    uint64_t red = 0;                  ///< Сумма красного в поддереве.
+    uint64_t green = 0;                ///< Сумма зелёного в поддереве.
+    uint64_t blue = 0;                 ///< Сумма синего в поддереве.
+    int32_t children[8] = {-1, -1, -1, -1, -1, -1, -1, -1};  ///< Потомки.
+    bool leaf = false;                 ///< Является ли узел листом.
+  };
+
+  /**
+   * @brief Перевод строки y изображения в индексы палитры.
+   */
+  void mapRow(const uint32_t *row, int y, int width, uint8_t *out);
+
+  /**
+   * @brief Добавление count пикселей цвета rgb в дерево.
+   */
+  static void insert(std::vector<Node> &tree,
+                     std::vector<int32_t> levels[kDepth],
+                     uint32_t rgb, uint64_t count, int &leaves);
+
+  /**
+   * @brief Индекс ближайшего цвета палитры.
+   */
+  int nearest(int red, int green, int blue) const noexcept;
+
+  /**
+   * @brief Индекс цвета палитры через таблицу ближайших цветов.
+   */
+  uint8_t lookup(int red, int green, int blue) noexcept;
+
+  int max_colors;                 ///< Наибольший размер палитры.
+  Dither dither;                  ///< Способ дизеринга.
+  std::vector<uint32_t> colors;   ///< Палитра.
+  std::vector<uint8_t> by_green;  ///< Индексы палитры по росту зелёного.
+  std::vector<int16_t> table;     ///< Ближайшие цвета (-1 — не вычислен).
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_COLOR_QUANTIZER_H_
@@ -41,6 +41,70 @@ class Controller {
     model.coreParser(file_name);
   }
 
+  /**
+   * @brief Загрузка модели из файла .obj в отдельные данные.
+   *
+   * Этот метод вызывает метод load() модели; экземпляр модели не
+   * изменяется, поэтому метод можно вызывать из фонового потока.
+   *
+   * @param file_name Путь к файлу .obj, содержащему модель.
+   * @param data Данные, заменяемые загруженной моделью.
+   * @param progress Ход загрузки и запрос отмены или nullptr.
+   * @return true, если модель загружена и загрузка не была отменена.
+   */
+  inline bool load(const char *file_name, Model::Data &data,
+                   Model::Progress *progress) const {
+    return model.load(file_name, data, progress);
+  }
+
+  /**
+   * @brief Замена данных модели загруженными.
+   *
+   * Этот метод вызывает метод replace() модели.
+   *
+   * @param data Данные, загруженные методом load().
+   */
+  inline void replace(Model::Data &&data) noexcept {
+    model.replace(std::move(data));
+  }
+
+  /**
+   * @brief Копирование вершин, уже разобранных фоновой загрузкой.
+   *
+   * Этот метод вызывает метод copyPreview() модели.
+   *
+   * @param progress Ход загрузки с флагом publish.
+   * @param preview Данные предпросмотра.
+   * @return true, если preview изменились.
+   */
+  inline bool copyPreview(Model::Progress &progress,
+                          Model::Data &preview) const {
+    return Model::copyPreview(progress, preview);
+  }
+
+  /**
+   * @brief Выбор каталога кэша разобранных моделей.
+   *
+   * Этот метод вызывает метод setCacheDirectory() модели.
+   *
+   * @param directory Каталог кэша; пустая строка отключает кэш.
+   */
+  inline void setCacheDirectory(const std::string &directory) {
+    model.setCacheDirectory(directory);
+  }
+
+  /**
+   * @brief Сохранение данных модели в кэш в пуле потоков.
+   *
+   * Этот метод вызывает метод storeCache() модели; результат записи не
+   * ожидается.
+   *
+   * @param file_name Путь к файлу .obj, из которого загружены данные.
+   */
+  inline void storeCache(const char *file_name) {
+    model.storeCache(file_name);
+  }
+
   /**
    * @brief Выполнение аффинных преобразований над моделью.
    *
@@ -0,0 +1,156 @@
+#include "decompressor.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#ifdef S21_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+/**
+ * @brief Состояние распаковщика выбранного формата.
+ */
+struct s21::Decompressor::Stream {
+  /**
+   * @brief Инициализация распаковщика формата format.
+   */
+  explicit Stream(Format format) : format(format) {
+    if (format == Format::kGzip) {
+      // 15 + 16: окно 32 КБ и только заголовок gzip
+      ready = inflateInit2(&zlib, 15 + 16) == Z_OK;
+#ifdef S21_WITH_ZSTD
+    } else if (format == Format::kZstd) {
+      zstd = ZSTD_createDStream();
+      ready = zstd && !ZSTD_isError(ZSTD_initDStream(zstd));
+#endif
+    }
+  }
+
+  ~Stream() {
+    if (format == Format::kGzip && ready) inflateEnd(&zlib);
+#ifdef S21_WITH_ZSTD
+    if (zstd) ZSTD_freeDStream(zstd);
+#endif
+  }
+
+  Format format;       ///< Формат сжатия.
+  bool ready = false;  ///< Распаковщик инициализирован.
+  z_stream zlib{};     ///< Состояние zlib для gzip.
+#ifdef S21_WITH_ZSTD
+  ZSTD_DStream *zstd = nullptr;  ///< Состояние zstd.
+#endif
+};
+
+/**
+ * @brief Определяет формат сжатия по первым четырём байтам файла.
+ */
+s21::Decompressor::Format s21::Decompressor::detect(
+    const char *file_name) noexcept {
+  int fd = open(file_name, O_RDONLY);
+  if (fd < 0) return Format::kNone;
+  unsigned char magic[4] = {};
+  ssize_t size = pread(fd, magic, sizeof(magic), 0);
+  close(fd);
+  if (size >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) return Format::kGzip;
+  if (size == 4 && magic[0] == 0x28 && magic[1] == 0xB5 &&
+      magic[2] == 0x2F && magic[3] == 0xFD)
+    return Format::kZstd;
+  return Format::kNone;
+}
+
+/**
+ * @brief Открывает сжатый файл и создаёт распаковщик его формата.
+ */
+s21::Decompressor::Decompressor(const char *file_name)
+    : input_(kInputSize) {
+  Format format = detect(file_name);
+  if (format == Format::kNone) return;
+  fd_ = open(file_name, O_RDONLY);
+  if (fd_ < 0) return;
+  struct stat st;
+  if (fstat(fd_, &st) == 0) size_ = static_cast<uint64_t>(st.st_size);
+  stream_ = std::make_unique<Stream>(format);
+  if (!stream_->ready) stream_.reset();
+}
+
+/**
+ * @brief Закрывает файл и освобождает распаковщик.
+ */
+s21::Decompressor::~Decompressor() {
+  if (fd_ >= 0) close(fd_);
+}
+
+/**
+ * @brief Читает следующую порцию сжатых данных.
+ */
+bool s21::Decompressor::refill() {
+  for (;;) {
+    ssize_t size = ::read(fd_, input_.data(), input_.size());
+    if (size < 0 && errno == EINTR) continue;
+    if (size < 0) failed_ = true;
+    if (size <= 0) return false;
+    input_size_ = static_cast<std::size_t>(size);
+    input_pos_ = 0;
+    consumed_ += input_size_;
+    return true;
+  }
+}
+
+/**
+ * @brief Распаковывает данные в буфер, пока он не заполнится.
+ *
+ * Когда заканчивается очередной сжатый поток, распаковщик сбрасывается и
+ * продолжает со следующего. Если файл кончается посреди потока, данные
+ * считаются обрезанными.
+ */
+std::size_t s21::Decompressor::read(char *buffer, std::size_t size) {
+  std::size_t produced = 0;
+  if (!isOpen()) return 0;
+  while (produced < size && !finished_) {
+    if (input_pos_ == input_size_ && !refill()) {
+      finished_ = true;
+      failed_ = failed_ || !frame_done_;
+      break;
+    }
+    if (stream_->format == Format::kGzip) {
+      z_stream &zlib = stream_->zlib;
+      zlib.next_in = reinterpret_cast<Bytef *>(input_.data() + input_pos_);
+      zlib.avail_in = static_cast<uInt>(input_size_ - input_pos_);
+      zlib.next_out = reinterpret_cast<Bytef *>(buffer + produced);
+      zlib.avail_out =
+          static_cast<uInt>(std::min<std::size_t>(size - produced, UINT_MAX));
+      uInt available = zlib.avail_out;
+      int status = inflate(&zlib, Z_NO_FLUSH);
+      input_pos_ = input_size_ - zlib.avail_in;
+      produced += available - zlib.avail_out;
+      if (status == Z_STREAM_END) {
+        frame_done_ = true;
+        inflateReset(&zlib);
+      } else if (status == Z_OK) {
+        frame_done_ = false;
+      } else if (status != Z_BUF_ERROR) {
+        failed_ = finished_ = true;
+      }
+#ifdef S21_WITH_ZSTD
+    } else {
+      ZSTD_inBuffer in = {input_.data(), input_size_, input_pos_};
+      ZSTD_outBuffer out = {buffer, size, produced};
+      std::size_t status = ZSTD_decompressStream(stream_->zstd, &out, &in);
+      input_pos_ = in.pos;
+      produced = out.pos;
+      if (ZSTD_isError(status))
+        failed_ = finished_ = true;
+      else
+        frame_done_ = status == 0;
+#endif
+    }
+  }
+  return produced;
+}
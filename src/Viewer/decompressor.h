@@ -0,0 +1,120 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением класса Decompressor — потоковой
+распаковки сжатых файлов моделей.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_DECOMPRESSOR_H_
+#define CPP4_3DVIEWER_V2_VIEWER_DECOMPRESSOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace s21 {
+
+/**
+ * @brief Потоковая распаковка файла gzip или zstd.
+ *
+ * Файл читается порциями по kInputSize байт и распаковывается в буфер
+ * вызывающего, поэтому ни сжатый, ни распакованный файл целиком в памяти не
+ * хранятся и временные файлы не создаются. Несколько сжатых потоков подряд
+ * (например, результат cat a.gz b.gz) распаковываются как один файл.
+ *
+ * Формат определяется по сигнатуре в начале файла, а не по расширению.
+ * Поддержка zstd включается макросом S21_WITH_ZSTD (нужна libzstd); без
+ * неё файл zstd распознаётся, но не открывается.
+ */
+class Decompressor {
+ public:
+  /**
+   * @brief Формат сжатия файла.
+   */
+  enum class Format {
+    kNone,  ///< Файл не сжат.
+    kGzip,  ///< gzip.
+    kZstd   ///< Zstandard.
+  };
+
+  /**
+   * @brief Определение формата сжатия файла по сигнатуре.
+   *
+   * @param file_name Путь к файлу.
+   * @return Format::kNone, если файл не сжат или недоступен.
+   */
+  static Format detect(const char *file_name) noexcept;
+
+  /**
+   * @brief Открытие сжатого файла.
+   *
+   * @param file_name Путь к файлу. Если файл не удалось открыть или его
+   * формат не поддерживается, isOpen() возвращает false.
+   */
+  explicit Decompressor(const char *file_name);
+  Decompressor(const Decompressor &other) = delete;
+  void operator=(const Decompressor &other) = delete;
+  ~Decompressor();
+
+  /**
+   * @brief Проверяет, удалось ли открыть файл.
+   */
+  inline bool isOpen() const noexcept { return fd_ >= 0 && stream_; }
+
+  /**
+   * @brief Чтение следующей порции распакованных данных.
+   *
+   * @param buffer Буфер для распакованных данных.
+   * @param size Размер буфера.
+   * @return Количество записанных байт; меньше size только в конце файла
+   * или при ошибке, 0 — данных больше нет.
+   */
+  std::size_t read(char *buffer, std::size_t size);
+
+  /**
+   * @brief Произошла ли ошибка чтения или распаковки.
+   *
+   * Обрезанный файл тоже считается ошибкой.
+   */
+  inline bool failed() const noexcept { return failed_; }
+
+  /**
+   * @brief Количество прочитанных сжатых байт.
+   */
+  inline uint64_t consumed() const noexcept { return consumed_; }
+
+  /**
+   * @brief Размер сжатого файла в байтах.
+   */
+  inline uint64_t size() const noexcept { return size_; }
+
+ private:
+  /**
+   * @brief Размер порции сжатых данных, читаемой из файла.
+   */
+  static constexpr std::size_t kInputSize = 1 << 18;
+
+  struct Stream;  ///< Состояние распаковщика выбранного формата.
+
+  /**
+   * @brief Чтение следующей порции сжатых данных в input_.
+   *
+   * @return false в конце файла или при ошибке чтения.
+   */
+  bool refill();
+
+  int fd_ = -1;                     ///< Дескриптор сжатого файла.
+  std::unique_ptr<Stream> stream_;  ///< Распаковщик.
+  std::vector<char> input_;         ///< Буфер сжатых данных.
+  std::size_t input_size_ = 0;      ///< Байт в input_.
+  std::size_t input_pos_ = 0;       ///< Распакованных байт input_.
+  uint64_t consumed_ = 0;           ///< Прочитано сжатых байт.
+  uint64_t size_ = 0;               ///< Размер сжатого файла.
+  bool frame_done_ = true;          ///< Последний сжатый поток завершён.
+  bool finished_ = false;           ///< Данных больше нет.
+  bool failed_ = false;             ///< Ошибка чтения или распаковки.
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_DECOMPRESSOR_H_
@@ -0,0 +1,54 @@
+#include "frame_delta.h"
+
+#include <cstring>
+
+/**
+ * @brief Наименьший прямоугольник, содержащий все изменившиеся пиксели.
+ *
+ * Совпадающие строки сверху и снизу отбрасываются сравнением memcmp(). В
+ * оставшихся строках столбцы просматриваются от краёв кадра только до уже
+ * найденных левой и правой границ.
+ */
+s21::FrameRect s21::changedRect(const uint32_t *current,
+                                const uint32_t *previous, int width,
+                                int height, std::size_t stride) noexcept {
+  const std::size_t row_bytes = width * sizeof(uint32_t);
+  auto row_changed = [&](int y) {
+    return std::memcmp(current + y * stride, previous + y * stride,
+                       row_bytes) != 0;
+  };
+  int top = 0, bottom = height - 1;
+  while (top <= bottom && !row_changed(top)) top++;
+  if (top > bottom) return FrameRect{};
+  while (!row_changed(bottom)) bottom--;
+
+  // Каждая строка просматривается только за пределами уже найденных столбцов
+  int left = width, right = -1;
+  for (int y = top; y <= bottom; y++) {
+    const uint32_t *a = current + y * stride, *b = previous + y * stride;
+    for (int x = 0; x < left; x++)
+      if (a[x] != b[x]) {
+        left = x;
+        break;
+      }
+    for (int x = width - 1; x > right; x--)
+      if (a[x] != b[x]) {
+        right = x;
+        break;
+      }
+  }
+  return FrameRect{left, top, right - left + 1, bottom - top + 1};
+}
+
+/**
+ * @brief Расширение области влево и вверх до краёв, кратных alignment.
+ *
+ * Область растёт на остаток от деления края на alignment, поэтому правый
+ * и нижний края остаются на месте.
+ */
+s21::FrameRect s21::alignRect(const FrameRect &rect, int alignment) noexcept {
+  if (rect.empty()) return FrameRect{};
+  const int dx = rect.x % alignment, dy = rect.y % alignment;
+  return FrameRect{rect.x - dx, rect.y - dy, rect.width + dx,
+                   rect.height + dy};
+}
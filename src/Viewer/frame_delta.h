@@ -0,0 +1,63 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением поиска изменившейся области между
+соседними кадрами GIF-анимации.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_FRAME_DELTA_H_
+#define CPP4_3DVIEWER_V2_VIEWER_FRAME_DELTA_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace s21 {
+
+/**
+ * @brief Прямоугольная область кадра в пикселях.
+ */
+struct FrameRect {
+  int x = 0;       ///< Левый край.
+  int y = 0;       ///< Верхний край.
+  int width = 0;   ///< Ширина.
+  int height = 0;  ///< Высота.
+
+  /**
+   * @brief Пуста ли область.
+   */
+  inline bool empty() const noexcept { return width <= 0 || height <= 0; }
+};
+
+/**
+ * @brief Наименьший прямоугольник, содержащий все изменившиеся пиксели.
+ *
+ * Кадры сравниваются попиксельно в формате 0xAARRGGBB; у кадров должны
+ * совпадать размеры и расстояние между строками. Совпадающие строки сверху и
+ * снизу отбрасываются сравнением строк целиком, затем в оставшихся строках
+ * ищутся крайние изменившиеся столбцы.
+ *
+ * @param current Пиксели нового кадра.
+ * @param previous Пиксели предыдущего кадра.
+ * @param width Ширина кадров.
+ * @param height Высота кадров.
+ * @param stride Расстояние между строками в пикселях.
+ * @return Пустая область, если кадры совпадают.
+ */
+FrameRect changedRect(const uint32_t *current, const uint32_t *previous,
+                      int width, int height, std::size_t stride) noexcept;
+
+/**
+ * @brief Расширение области влево и вверх до краёв, кратных alignment.
+ *
+ * Правый и нижний края не меняются, поэтому область не выходит за пределы
+ * кадра. Так матрица дизеринга ложится на одни и те же пиксели холста, где
+ * бы ни начиналась изменившаяся область.
+ *
+ * @param rect Область кадра.
+ * @param alignment Кратность левого и верхнего краёв.
+ * @return Пустая область, если rect пуста.
+ */
+FrameRect alignRect(const FrameRect &rect, int alignment) noexcept;
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_FRAME_DELTA_H_
@@ -0,0 +1,153 @@
+#include "gif_recorder.h"
+
+/**
+ * @brief Открытие файла и запуск потока кодировщика.
+ *
+ * Если файл не удалось открыть, поток не запускается и isOpen() возвращает
+ * false.
+ *
+ * @param file_name Путь к файлу анимации.
+ * @param delay Задержка между кадрами анимации в миллисекундах.
+ */
+s21::GifRecorder::GifRecorder(const QString &file_name, int delay,
+                              ColorQuantizer::Dither dither)
+    : quantizer(ColorQuantizer::kMaxColors - 1, dither), frame_delay(delay) {
+  gif.setDefaultDelay(delay);
+  if (gif.open(file_name)) encoder = std::thread(&GifRecorder::encode, this);
+}
+
+/**
+ * @brief Завершение записи.
+ *
+ * Закрывает очередь и дожидается окончания работы кодировщика.
+ */
+s21::GifRecorder::~GifRecorder() {
+  frames.close();
+  if (encoder.joinable()) encoder.join();
+}
+
+/**
+ * @brief Передача кадра кодировщику без ожидания.
+ *
+ * QImage разделяет данные неявно, поэтому в очередь попадает только ссылка
+ * на пиксели кадра, без копирования. Задержка пропущенного кадра переходит
+ * к следующему принятому.
+ */
+bool s21::GifRecorder::addFrame(const QImage &frame) {
+  if (isOpen() && frames.tryPush(Frame{frame, frame_delay + skipped_delay})) {
+    skipped_delay = 0;
+    return true;
+  }
+  skipped_delay += frame_delay;
+  dropped++;
+  return false;
+}
+
+/**
+ * @brief Передача кадра кодировщику с ожиданием места в очереди.
+ */
+bool s21::GifRecorder::pushFrame(const QImage &frame) {
+  if (!isOpen() || !frames.push(Frame{frame, frame_delay + skipped_delay}))
+    return false;
+  skipped_delay = 0;
+  return true;
+}
+
+/**
+ * @brief Завершение приёма кадров.
+ */
+void s21::GifRecorder::finish() { frames.close(); }
+
+/**
+ * @brief Цикл потока кодировщика.
+ *
+ * Каждый кадр переводится в палитру сразу после получения и передаётся на
+ * сжатие; после закрытия очереди QGifImage::close() дожидается сжатия
+ * оставшихся кадров и записывает конец файла. Палитра первого кадра
+ * становится общей: она должна быть известна до записи заголовка файла
+ * вместе с первым кадром.
+ *
+ * Левый и верхний края изменившейся области выравниваются на сторону
+ * матрицы дизеринга (alignRect()), чтобы она ложилась на одни и те же
+ * пиксели холста. Если кадр не изменился, записывается один прозрачный
+ * пиксель: кадр нужен для сохранения задержки.
+ *
+ * Размер холста задаёт первый кадр. Кадры другого размера (окно изменили
+ * во время записи) масштабируются до него: кадр, выходящий за пределы
+ * холста, декодеры обрезают или отвергают.
+ */
+void s21::GifRecorder::encode() {
+  Frame item;
+  while (frames.pop(item)) {
+    QImage &frame = item.image;
+    if (frame.isNull()) continue;  // Захват кадрового буфера не удался
+    if (!previous.isNull() && frame.size() != previous.size())
+      frame = frame.scaled(previous.size(), Qt::IgnoreAspectRatio,
+                           Qt::FastTransformation);
+    QImage pixels = frame.convertToFormat(QImage::Format_ARGB32);
+    if (!quantizer.hasPalette()) createPalette(pixels);
+    QRect rect = pixels.rect();
+    if (!previous.isNull()) {
+      FrameRect changed = alignRect(
+          changedRect(reinterpret_cast<const uint32_t *>(pixels.constBits()),
+                      reinterpret_cast<const uint32_t *>(previous.constBits()),
+                      pixels.width(), pixels.height(),
+                      pixels.bytesPerLine() / 4),
+          ColorQuantizer::kDitherSize);
+      rect = QRect(changed.x, changed.y, changed.width, changed.height);
+    }
+    if (rect.isEmpty()) {
+      QImage pixel(1, 1, QImage::Format_Indexed8);
+      pixel.setColorTable(colors);
+      pixel.fill(static_cast<uint>(colors.size() - 1));
+      gif.writeFrame(pixel, QPoint(0, 0), item.delay);
+    } else {
+      gif.writeFrame(quantize(pixels, rect), rect.topLeft(), item.delay);
+    }
+    previous = pixels;
+  }
+  gif.close();
+  finished = true;
+}
+
+/**
+ * @brief Построение общей палитры по первому кадру.
+ *
+ * После цветов палитры добавляется прозрачный цвет — любой цвет, которого
+ * нет в палитре (ColorQuantizer::unusedColor()), чтобы QGifImage нашёл его
+ * индекс однозначно.
+ */
+void s21::GifRecorder::createPalette(const QImage &pixels) {
+  quantizer.buildPalette(reinterpret_cast<const uint32_t *>(pixels.constBits()),
+                         pixels.width(), pixels.height(),
+                         pixels.bytesPerLine() / 4);
+  const std::vector<uint32_t> &palette = quantizer.palette();
+  colors = QVector<QRgb>(palette.begin(), palette.end());
+  const QRgb transparent = quantizer.unusedColor();
+  colors.append(transparent);
+  gif.setGlobalColorTable(colors);
+  gif.setDefaultTransparentColor(QColor(transparent));
+}
+
+/**
+ * @brief Перевод изменившейся области кадра в общую палитру.
+ *
+ * Таблица цветов результата совпадает с глобальной таблицей анимации,
+ * поэтому у кадров нет собственных таблиц цветов. Пиксели области, не
+ * изменившиеся с предыдущего кадра, получают прозрачный индекс.
+ */
+QImage s21::GifRecorder::quantize(const QImage &pixels, const QRect &rect) {
+  QImage indexed(rect.size(), QImage::Format_Indexed8);
+  indexed.setColorTable(colors);
+  const std::size_t stride = pixels.bytesPerLine() / 4;
+  const std::size_t offset = rect.y() * stride + rect.x();
+  const uint32_t *before =
+      previous.isNull()
+          ? nullptr
+          : reinterpret_cast<const uint32_t *>(previous.constBits()) + offset;
+  quantizer.map(
+      reinterpret_cast<const uint32_t *>(pixels.constBits()) + offset,
+      rect.width(), rect.height(), stride, indexed.bits(),
+      indexed.bytesPerLine(), before, static_cast<uint8_t>(colors.size() - 1));
+  return indexed;
+}
@@ -0,0 +1,160 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением класса GifRecorder — фоновой записи
+GIF-анимации.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_GIF_RECORDER_H_
+#define CPP4_3DVIEWER_V2_VIEWER_GIF_RECORDER_H_
+
+#include <QImage>
+#include <QRect>
+#include <QString>
+#include <atomic>
+#include <thread>
+
+#include "bounded_queue.h"
+#include "color_quantizer.h"
+#include "frame_delta.h"
+#include "qgifimage.h"
+
+namespace s21 {
+
+/**
+ * @brief Запись GIF-анимации в отдельном потоке.
+ *
+ * Поток интерфейса только передаёт готовые кадры в очередь ограниченного
+ * размера, а поток кодировщика переводит каждый кадр в палитру из 256
+ * цветов и передаёт его QGifImage::writeFrame(), который сжимает несколько
+ * кадров одновременно в пуле потоков Qt и дописывает их в файл по порядку.
+ * Несжатые кадры не накапливаются, поэтому занятая память не зависит от
+ * длины записи. Если кодировщик не успевает и очередь заполнена, addFrame()
+ * не ждёт, а пропускает кадр: поток интерфейса не должен останавливаться.
+ * Время пропущенных кадров добавляется к задержке следующего принятого,
+ * поэтому длительность анимации сохраняется.
+ *
+ * Палитра строится ColorQuantizer по первому кадру и записывается как общая
+ * для всей анимации; остальные кадры переводятся в неё же.
+ *
+ * Кадр сравнивается с предыдущим, и в файл записывается только
+ * прямоугольник, содержащий изменившиеся пиксели (changedRect()); пиксели
+ * прямоугольника, оставшиеся прежними, записываются прозрачными. Под
+ * прозрачный цвет отводится последний индекс палитры, поэтому ColorQuantizer
+ * строит палитру не более чем из 255 цветов. При медленном вращении модели
+ * фон и неподвижные части кадра не кодируются повторно, что уменьшает и
+ * размер файла, и время сжатия.
+ */
+class GifRecorder {
+ public:
+  /**
+   * @brief Открытие файла и запуск потока кодировщика.
+   *
+   * @param file_name Путь к файлу анимации.
+   * @param delay Задержка между кадрами анимации в миллисекундах.
+   * @param dither Способ дизеринга при переводе кадров в палитру.
+   */
+  GifRecorder(const QString &file_name, int delay,
+              ColorQuantizer::Dither dither = ColorQuantizer::Dither::kNone);
+
+  /**
+   * @brief Завершение записи.
+   *
+   * Дожидается, пока кодировщик допишет переданные кадры и закроет файл.
+   */
+  ~GifRecorder();
+
+  GifRecorder(const GifRecorder &other) = delete;
+  void operator=(const GifRecorder &other) = delete;
+
+  /**
+   * @brief Удалось ли открыть файл анимации.
+   */
+  inline bool isOpen() const noexcept { return encoder.joinable(); }
+
+  /**
+   * @brief Закрыл ли кодировщик файл анимации.
+   *
+   * Если да, деструктор не ждёт поток кодировщика.
+   */
+  inline bool isFinished() const noexcept { return finished; }
+
+  /**
+   * @brief Количество кадров, пропущенных из-за заполненной очереди.
+   */
+  inline std::size_t droppedFrames() const noexcept { return dropped; }
+
+  /**
+   * @brief Передача кадра кодировщику без ожидания.
+   *
+   * Вызывается из одного потока.
+   *
+   * @param frame Кадр анимации.
+   * @return false, если кадр пропущен: очередь заполнена или запись уже
+   * завершена.
+   */
+  bool addFrame(const QImage &frame);
+
+  /**
+   * @brief Передача кадра кодировщику с ожиданием места в очереди.
+   *
+   * Для записи без интерфейса (ViewerBatch), где кадры не пропускаются, а
+   * поток, отрисовывающий кадры, ждёт кодировщик. Вызывается из того же
+   * потока, что и addFrame().
+   *
+   * @param frame Кадр анимации.
+   * @return false, если файл не открыт или запись уже завершена.
+   */
+  bool pushFrame(const QImage &frame);
+
+  /**
+   * @brief Завершение приёма кадров.
+   *
+   * Возвращается сразу: оставшиеся кадры кодируются и файл закрывается в
+   * потоке кодировщика.
+   */
+  void finish();
+
+ private:
+  /**
+   * @brief Количество кадров, ожидающих кодирования.
+   */
+  static constexpr std::size_t kQueueCapacity = 8;
+
+  /**
+   * @brief Кадр в очереди кодировщика.
+   */
+  struct Frame {
+    QImage image;  ///< Кадр анимации.
+    int delay = 0;  ///< Задержка с учётом пропущенных перед ним кадров.
+  };
+
+  /**
+   * @brief Цикл потока кодировщика.
+   */
+  void encode();
+
+  /**
+   * @brief Построение общей палитры по первому кадру.
+   */
+  void createPalette(const QImage &pixels);
+
+  /**
+   * @brief Перевод изменившейся области кадра в общую палитру.
+   */
+  QImage quantize(const QImage &pixels, const QRect &rect);
+
+  BoundedQueue<Frame> frames{kQueueCapacity};  ///< Очередь кадров.
+  QGifImage gif;             ///< Анимация (только для кодировщика).
+  ColorQuantizer quantizer;  ///< Общая палитра кадров.
+  QVector<QRgb> colors;      ///< Общая палитра с прозрачным цветом.
+  QImage previous;           ///< Предыдущий кадр в формате ARGB32.
+  int frame_delay;           ///< Задержка между кадрами.
+  int skipped_delay = 0;     ///< Время кадров, пропущенных подряд.
+  std::size_t dropped = 0;   ///< Всего пропущено кадров.
+  std::atomic<bool> finished{false};  ///< Файл анимации закрыт.
+  std::thread encoder;       ///< Поток кодировщика.
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_GIF_RECORDER_H_
@@ -0,0 +1,45 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Отображает файл в память.
+ *
+ * Файл открывается только для чтения и отображается целиком. Ядру
+ * сообщается, что доступ будет последовательным, чтобы упреждающее чтение
+ * работало на полную глубину. Пустой файл считается успешно открытым, но
+ * не отображается.
+ *
+ * @param file_name Путь к файлу.
+ */
+s21::MappedFile::MappedFile(const char *file_name) noexcept {
+  int fd = open(file_name, O_RDONLY);
+  if (fd < 0) return;
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    size_ = static_cast<std::size_t>(st.st_size);
+    is_open_ = true;
+    if (size_ > 0) {
+      void *addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char *>(addr);
+      } else {
+        size_ = 0;
+        is_open_ = false;
+      }
+    }
+  }
+  close(fd);
+}
+
+/**
+ * @brief Освобождает отображение файла.
+ */
+s21::MappedFile::~MappedFile() {
+  if (data_) munmap(const_cast<char *>(data_), size_);
+}
@@ -0,0 +1,63 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением класса MappedFile, который отображает
+файл в память только для чтения.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_MAPPED_FILE_H_
+#define CPP4_3DVIEWER_V2_VIEWER_MAPPED_FILE_H_
+
+#include <cstddef>
+
+namespace s21 {
+
+/**
+ * @brief Отображение файла в память только для чтения.
+ *
+ * Класс открывает файл и отображает его содержимое в адресное пространство
+ * процесса через mmap, чтобы парсер мог читать данные напрямую без
+ * промежуточного копирования в буферы потоков. Отображение освобождается в
+ * деструкторе.
+ */
+class MappedFile {
+ public:
+  /**
+   * @brief Отображает файл в память.
+   *
+   * @param file_name Путь к файлу. Если файл не удалось открыть, объект
+   * остаётся пустым (isOpen() возвращает false).
+   */
+  explicit MappedFile(const char *file_name) noexcept;
+  MappedFile(const MappedFile &other) = delete;
+  void operator=(const MappedFile &other) = delete;
+  ~MappedFile();
+
+  /**
+   * @brief Проверяет, удалось ли открыть файл.
+   */
+  inline bool isOpen() const noexcept { return is_open_; }
+
+  /**
+   * @brief Указатель на начало содержимого файла.
+   */
+  inline const char *begin() const noexcept { return data_; }
+
+  /**
+   * @brief Указатель на позицию за последним байтом файла.
+   */
+  inline const char *end() const noexcept { return data_ + size_; }
+
+  /**
+   * @brief Размер файла в байтах.
+   */
+  inline std::size_t size() const noexcept { return size_; }
+
+ private:
+  const char *data_ = nullptr;  ///< Начало отображённой области.
+  std::size_t size_ = 0;        ///< Размер отображённой области.
+  bool is_open_ = false;        ///< Признак успешно открытого файла.
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_MAPPED_FILE_H_
@@ -0,0 +1,357 @@
+#include "mesh_cache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace {
+
+/**
+ * @brief Сигнатура файла кэша.
+ */
+constexpr char kMagic[8] = "S21MESH";
+
+/**
+ * @brief Хеш FNV-1a, продолженный с состояния hash.
+ */
+uint64_t fnv1a(const void *data, std::size_t size,
+               uint64_t hash = 0xCBF29CE484222325ull) noexcept {
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < size; i++) {
+    hash ^= p[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+/**
+ * @brief Наименьшее число, кратное alignment и не меньшее offset.
+ */
+constexpr std::size_t alignUp(std::size_t offset,
+                              std::size_t alignment) noexcept {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief Создание каталога path вместе с недостающими родительскими.
+ */
+bool makeDirectories(const std::string &path) {
+  for (std::size_t slash = path.find('/', 1); slash != std::string::npos;
+       slash = path.find('/', slash + 1))
+    if (mkdir(path.substr(0, slash).c_str(), 0755) != 0 && errno != EEXIST)
+      return false;
+  return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+/**
+ * @brief Время изменения файла в наносекундах.
+ */
+int64_t mtimeOf(const struct stat &st) noexcept {
+#ifdef __APPLE__
+  const struct timespec &mtime = st.st_mtimespec;
+#else
+  const struct timespec &mtime = st.st_mtim;
+#endif
+  return static_cast<int64_t>(mtime.tv_sec) * 1000000000 + mtime.tv_nsec;
+}
+
+/**
+ * @brief Запись size байт data в файл fd целиком.
+ *
+ * Данные записываются блоками не больше block байт; перед каждым блоком
+ * проверяется запрос отмены cancelled, если он задан.
+ */
+bool writeAll(int fd, const void *data, std::size_t size, std::size_t block,
+              const std::atomic<bool> *cancelled) {
+  const char *p = static_cast<const char *>(data);
+  while (size > 0) {
+    if (cancelled && cancelled->load(std::memory_order_relaxed)) return false;
+    ssize_t written = write(fd, p, std::min(size, block));
+    if (written < 0 && errno == EINTR) continue;
+    if (written <= 0) return false;
+    p += written;
+    size -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+}  // namespace
+
+/**
+ * @brief Каталог кэша по умолчанию по спецификации XDG.
+ */
+std::string s21::MeshCache::defaultDirectory() {
+  const char *xdg = std::getenv("XDG_CACHE_HOME");
+  if (xdg && *xdg == '/') return std::string(xdg) + "/3DViewer/meshes";
+  const char *home = std::getenv("HOME");
+  if (home && *home) return std::string(home) + "/.cache/3DViewer/meshes";
+  return std::string();
+}
+
+/**
+ * @brief Путь к файлу кэша для файла .obj.
+ *
+ * Путь к файлу .obj приводится к абсолютному, чтобы разные относительные
+ * пути к одному файлу использовали один кэш.
+ */
+std::string s21::MeshCache::pathFor(const char *source) const {
+  char resolved[PATH_MAX];
+  const char *path = realpath(source, resolved) ? resolved : source;
+  char name[24];
+  std::snprintf(name, sizeof(name), "%016llx.mesh",
+                static_cast<unsigned long long>(
+                    fnv1a(path, std::strlen(path))));
+  return directory + "/" + name;
+}
+
+/**
+ * @brief Признаки исходного файла.
+ *
+ * Читаются только первые и последние kStampBytes байт файла, поэтому
+ * проверка занимает одинаковое время для файла любого размера.
+ */
+bool s21::MeshCache::stampOf(const char *source, Stamp &stamp) {
+  int fd = open(source, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  bool ok = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+  if (ok) {
+    stamp.size = static_cast<uint64_t>(st.st_size);
+    stamp.mtime = mtimeOf(st);
+    std::vector<char> buffer(
+        std::min<uint64_t>(stamp.size, 2 * kStampBytes));
+    std::size_t head = std::min<std::size_t>(buffer.size(), kStampBytes);
+    std::size_t tail = buffer.size() - head;
+    ok = pread(fd, buffer.data(), head, 0) == static_cast<ssize_t>(head) &&
+         pread(fd, buffer.data() + head, tail, stamp.size - tail) ==
+             static_cast<ssize_t>(tail);
+    stamp.hash = fnv1a(buffer.data(), buffer.size());
+  }
+  close(fd);
+  return ok;
+}
+
+/**
+ * @brief Смещения массивов в файле кэша.
+ */
+s21::MeshCache::Layout s21::MeshCache::layoutOf(
+    const Header &header) noexcept {
+  Layout layout;
+  layout.vertexes = alignUp(sizeof(Header), kAlignment);
+  layout.indexes = alignUp(
+      layout.vertexes + header.vertexes * 3 * sizeof(float), kAlignment);
+  layout.offsets = alignUp(
+      layout.indexes + header.indexes * sizeof(uint32_t), kAlignment);
+  layout.edges = alignUp(
+      layout.offsets + (header.polygons + 1) * sizeof(uint32_t), kAlignment);
+  layout.size = layout.edges + header.edges * 2 * sizeof(uint32_t);
+  return layout;
+}
+
+/**
+ * @brief Соответствие заголовка файлу кэша и исходному файлу.
+ *
+ * Счётчики проверяются до вычисления смещений, чтобы исключить
+ * переполнение на повреждённом заголовке.
+ */
+bool s21::MeshCache::matches(const Header &header, const Stamp &stamp,
+                             uint64_t size) noexcept {
+  const uint64_t count = size / sizeof(uint32_t);
+  return std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+         header.version == kVersion && header.byte_order == kByteOrder &&
+         header.header_size == sizeof(Header) &&
+         header.source.size == stamp.size &&
+         header.source.mtime == stamp.mtime &&
+         header.source.hash == stamp.hash && header.vertexes <= count &&
+         header.indexes <= count && header.polygons < count &&
+         header.edges <= count && layoutOf(header).size == size;
+}
+
+/**
+ * @brief Проверка актуальности кэша по заголовку.
+ */
+bool s21::MeshCache::isCurrent(const char *source) const {
+  if (directory.empty()) return false;
+  Stamp stamp;
+  if (!stampOf(source, stamp)) return false;
+  int fd = open(pathFor(source).c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  Header header;
+  bool ok = fstat(fd, &st) == 0 &&
+            pread(fd, &header, sizeof(Header), 0) ==
+                static_cast<ssize_t>(sizeof(Header)) &&
+            matches(header, stamp, static_cast<uint64_t>(st.st_size));
+  close(fd);
+  return ok;
+}
+
+/**
+ * @brief Загрузка модели из кэша.
+ *
+ * Файл кэша отображается в память; после проверки заголовка, размера и
+ * содержимого массивов каждый массив копируется в данные модели одним
+ * копированием. Данные
+ * модели владеют своими массивами (их загружает в видеопамять отрисовка и
+ * читает растеризатор), поэтому отображение не используется напрямую.
+ */
+bool s21::MeshCache::load(const char *source, Model::Data &data,
+                          uint64_t *source_size) const {
+  if (directory.empty()) return false;
+  Stamp stamp;
+  if (!stampOf(source, stamp)) return false;
+  const std::string path = pathFor(source);
+  MappedFile file(path.c_str());
+  if (!file.isOpen() || file.size() < sizeof(Header)) return false;
+
+  Header header;
+  std::memcpy(&header, file.begin(), sizeof(Header));
+  if (!matches(header, stamp, file.size())) return false;
+
+  const Layout layout = layoutOf(header);
+  auto section = [&file](std::size_t offset) {
+    return reinterpret_cast<const uint32_t *>(file.begin() + offset);
+  };
+  const uint32_t *offsets = section(layout.offsets);
+  if (offsets[0] != 0 || offsets[header.polygons] != header.indexes ||
+      !std::is_sorted(offsets, offsets + header.polygons + 1))
+    return false;
+  // Отрисовка и растеризатор обращаются к вершинам по индексам без
+  // проверок, поэтому индекс за пределами вершин делает кэш недействительным
+  auto valid = [&header](const uint32_t *begin, uint64_t count) {
+    return std::all_of(begin, begin + count, [&header](uint32_t index) {
+      return index < header.vertexes;
+    });
+  };
+  if (!valid(section(layout.indexes), header.indexes) ||
+      !valid(section(layout.edges), header.edges * 2))
+    return false;
+
+  data = Model::Data();
+  data.vertexes.assign(
+      reinterpret_cast<const float *>(file.begin() + layout.vertexes),
+      header.vertexes);
+  data.faces.indexes.assign(section(layout.indexes),
+                            section(layout.indexes) + header.indexes);
+  data.faces.offsets.assign(offsets, offsets + header.polygons + 1);
+  data.edges.assign(section(layout.edges),
+                    section(layout.edges) + header.edges * 2);
+  data.count_of_vertexes = static_cast<unsigned int>(header.vertexes);
+  data.count_of_polygons = static_cast<unsigned int>(header.polygons);
+  data.count_of_edges = static_cast<unsigned int>(header.edges);
+  data.minX = header.bounds[0], data.minY = header.bounds[1];
+  data.minZ = header.bounds[2];
+  data.maxX = header.bounds[3], data.maxY = header.bounds[4];
+  data.maxZ = header.bounds[5];
+  if (source_size) *source_size = stamp.size;
+  utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+  return true;
+}
+
+/**
+ * @brief Сохранение разобранной модели в кэш.
+ *
+ * Между массивами записываются нули до ближайшей границы kAlignment.
+ * Временный файл создаётся в том же каталоге, поэтому переименование
+ * атомарно.
+ */
+bool s21::MeshCache::store(const char *source, const Model::Data &data,
+                           const std::atomic<bool> *cancelled) const {
+  if (directory.empty() || !makeDirectories(directory)) return false;
+  Header header{};
+  if (!stampOf(source, header.source)) return false;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byte_order = kByteOrder;
+  header.header_size = sizeof(Header);
+  header.vertexes = data.vertexes.size();
+  header.indexes = data.faces.indexes.size();
+  header.polygons = data.faces.size();
+  header.edges = data.edges.size() / 2;
+  const double bounds[6] = {data.minX, data.minY, data.minZ,
+                            data.maxX, data.maxY, data.maxZ};
+  std::copy(bounds, bounds + 6, header.bounds);
+  const Layout layout = layoutOf(header);
+
+  const std::string path = pathFor(source);
+  std::string temporary = path + ".XXXXXX";
+  int fd = mkstemp(&temporary[0]);
+  if (fd < 0) return false;
+
+  std::size_t position = 0;
+  auto put = [&](std::size_t offset, const void *bytes, std::size_t size) {
+    static const char zeros[kAlignment] = {};
+    if (!writeAll(fd, zeros, offset - position, kWriteBlock, cancelled))
+      return false;
+    position = offset + size;
+    return size == 0 || writeAll(fd, bytes, size, kWriteBlock, cancelled);
+  };
+  bool ok =
+      put(0, &header, sizeof(Header)) &&
+      put(layout.vertexes, data.vertexes.data(),
+          header.vertexes * 3 * sizeof(float)) &&
+      put(layout.indexes, data.faces.indexes.data(),
+          header.indexes * sizeof(uint32_t)) &&
+      put(layout.offsets, data.faces.offsets.data(),
+          (header.polygons + 1) * sizeof(uint32_t)) &&
+      put(layout.edges, data.edges.data(),
+          header.edges * 2 * sizeof(uint32_t));
+  ok = close(fd) == 0 && ok;
+  if (ok) ok = std::rename(temporary.c_str(), path.c_str()) == 0;
+  if (!ok) unlink(temporary.c_str());
+  if (ok) evict(path);
+  return ok;
+}
+
+/**
+ * @brief Удаление давно не использовавшихся файлов кэша.
+ *
+ * Файлы .mesh каталога сортируются по времени изменения, и самые старые
+ * удаляются, пока суммарный размер превышает limit. Временные файлы
+ * незавершённых записей не учитываются. Другой процесс, отобразивший
+ * удаляемый файл в память, продолжает читать его до закрытия.
+ */
+void s21::MeshCache::evict(const std::string &kept) const {
+  struct Entry {
+    std::string path;
+    uint64_t size;
+    int64_t mtime;
+  };
+  std::vector<Entry> entries;
+  uint64_t total = 0;
+  DIR *dir = opendir(directory.c_str());
+  if (!dir) return;
+  static const char kSuffix[] = ".mesh";
+  const std::size_t suffix = sizeof(kSuffix) - 1;
+  for (struct dirent *entry = readdir(dir); entry; entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    struct stat st;
+    if (name.size() <= suffix ||
+        name.compare(name.size() - suffix, suffix, kSuffix) != 0)
+      continue;
+    const std::string path = directory + "/" + name;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+    total += static_cast<uint64_t>(st.st_size);
+    if (path != kept)
+      entries.push_back({path, static_cast<uint64_t>(st.st_size),
+                         mtimeOf(st)});
+  }
+  closedir(dir);
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b) { return a.mtime < b.mtime; });
+  for (const Entry &entry : entries) {
+    if (total <= limit) break;
+    if (unlink(entry.path.c_str()) == 0) total -= entry.size;
+  }
+}
@@ -0,0 +1,209 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением класса MeshCache — двоичного кэша
+разобранных моделей.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_MESH_CACHE_H_
+#define CPP4_3DVIEWER_V2_VIEWER_MESH_CACHE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "model.h"
+
+namespace s21 {
+
+/**
+ * @brief Двоичный кэш разобранных файлов .obj.
+ *
+ * Для каждого разобранного файла в каталоге кэша сохраняется файл .mesh с
+ * готовыми массивами модели: вершинами, индексами и началами полигонов,
+ * рёбрами, счётчиками и границами. При следующем открытии того же файла кэш
+ * отображается в память, и массивы копируются из него целиком, без разбора
+ * текста и построения рёбер, поэтому загрузка ограничена скоростью чтения
+ * страниц файла, а не разбором.
+ *
+ * Формат: заголовок Header, затем массивы в указанном порядке, каждый с
+ * начала, кратного kAlignment. Числа записываются в порядке байтов машины;
+ * кэш другой версии формата, с другим порядком байтов или от изменившегося
+ * файла .obj не используется и перезаписывается после разбора.
+ *
+ * Изменение исходного файла определяется по размеру, времени изменения и
+ * хешу первых и последних kStampBytes байт: хеш всего файла потребовал бы
+ * читать его целиком при каждом открытии.
+ *
+ * Суммарный размер файлов .mesh в каталоге ограничен: после каждой записи
+ * удаляются файлы, дольше всех не использовавшиеся. Время последнего
+ * использования — время изменения файла кэша, которое обновляется при
+ * каждой загрузке из него.
+ */
+class MeshCache {
+ public:
+  /**
+   * @brief Версия формата файла кэша.
+   */
+  static constexpr uint32_t kVersion = 1;
+
+  /**
+   * @brief Предел суммарного размера файлов кэша по умолчанию (1 ГиБ).
+   */
+  static constexpr uint64_t kDefaultLimit = uint64_t(1) << 30;
+
+  /**
+   * @brief Размер блока записи файла кэша, между блоками проверяется отмена.
+   */
+  static constexpr std::size_t kWriteBlock = 1 << 22;
+
+  /**
+   * @brief Кэш в каталоге directory.
+   *
+   * @param directory Каталог кэша; создаётся при первой записи. Пустая строка
+   * отключает кэш.
+   * @param limit Предел суммарного размера файлов кэша в байтах. Только что
+   * записанный файл не удаляется, даже если сам превышает предел.
+   */
+  explicit MeshCache(std::string directory,
+                     uint64_t limit = kDefaultLimit) noexcept
+      : directory(std::move(directory)), limit(limit) {}
+
+  /**
+   * @brief Каталог кэша по умолчанию.
+   *
+   * $XDG_CACHE_HOME/3DViewer/meshes или ~/.cache/3DViewer/meshes; пустая
+   * строка, если не задана ни одна из переменных окружения.
+   */
+  static std::string defaultDirectory();
+
+  /**
+   * @brief Путь к файлу кэша для файла .obj.
+   *
+   * Имя файла кэша — хеш абсолютного пути к файлу .obj.
+   */
+  std::string pathFor(const char *source) const;
+
+  /**
+   * @brief Проверка, что в кэше есть актуальная копия файла .obj.
+   *
+   * Читает только заголовок файла кэша; содержимое массивов не проверяется.
+   */
+  bool isCurrent(const char *source) const;
+
+  /**
+   * @brief Загрузка модели из кэша.
+   *
+   * При успехе обновляет время изменения файла кэша (см. предел размера).
+   *
+   * @param source Путь к файлу .obj.
+   * @param data Данные, заменяемые содержимым кэша при успехе.
+   * @param[out] source_size Если не nullptr, сюда при успехе записывается
+   * размер файла .obj в байтах, уже прочитанный при проверке кэша.
+   * @return false, если кэша нет, он устарел или повреждён (в том числе
+   * если индекс вершины выходит за пределы вершин или начала полигонов не
+   * упорядочены); data при этом не изменяется.
+   */
+  bool load(const char *source, Model::Data &data,
+            uint64_t *source_size = nullptr) const;
+
+  /**
+   * @brief Сохранение разобранной модели в кэш.
+   *
+   * Файл записывается под временным именем и переименовывается, поэтому
+   * другой процесс никогда не увидит недописанный кэш. После записи
+   * удаляются давно не использовавшиеся файлы сверх предела размера.
+   *
+   * @param source Путь к разобранному файлу .obj.
+   * @param data Результат разбора.
+   * @param cancelled Если не nullptr, запрос отмены, проверяемый между
+   * блоками kWriteBlock; отменённая запись не оставляет файлов.
+   * @return true, если кэш записан.
+   */
+  bool store(const char *source, const Model::Data &data,
+             const std::atomic<bool> *cancelled = nullptr) const;
+
+ private:
+  /**
+   * @brief Выравнивание начала массивов в файле кэша.
+   */
+  static constexpr std::size_t kAlignment = 64;
+
+  /**
+   * @brief Количество байт начала и конца файла .obj, входящих в хеш.
+   */
+  static constexpr std::size_t kStampBytes = 1 << 16;
+
+  /**
+   * @brief Метка порядка байтов: в файле с другим порядком читается иначе.
+   */
+  static constexpr uint32_t kByteOrder = 0x01020304;
+
+  /**
+   * @brief Признаки исходного файла .obj.
+   */
+  struct Stamp {
+    uint64_t size = 0;  ///< Размер в байтах.
+    int64_t mtime = 0;  ///< Время изменения в наносекундах.
+    uint64_t hash = 0;  ///< Хеш начала и конца файла.
+  };
+
+  /**
+   * @brief Заголовок файла кэша.
+   */
+  struct Header {
+    char magic[8];         ///< "S21MESH".
+    uint32_t version;      ///< kVersion.
+    uint32_t byte_order;   ///< kByteOrder.
+    uint64_t header_size;  ///< sizeof(Header).
+    Stamp source;          ///< Признаки исходного файла.
+    uint64_t vertexes;     ///< Количество вершин.
+    uint64_t indexes;      ///< Количество индексов вершин полигонов.
+    uint64_t polygons;     ///< Количество полигонов.
+    uint64_t edges;        ///< Количество рёбер.
+    double bounds[6];      ///< minX, minY, minZ, maxX, maxY, maxZ.
+  };
+
+  /**
+   * @brief Смещения массивов в файле кэша.
+   */
+  struct Layout {
+    std::size_t vertexes;  ///< Вершины (float x3).
+    std::size_t indexes;   ///< Индексы вершин полигонов (uint32).
+    std::size_t offsets;   ///< Начала полигонов (uint32, polygons + 1).
+    std::size_t edges;     ///< Рёбра (uint32 x2).
+    std::size_t size;      ///< Размер файла.
+  };
+
+  /**
+   * @brief Признаки файла source; false, если файл недоступен.
+   */
+  static bool stampOf(const char *source, Stamp &stamp);
+
+  /**
+   * @brief Смещения массивов для заголовка header.
+   */
+  static Layout layoutOf(const Header &header) noexcept;
+
+  /**
+   * @brief Соответствие заголовка файла кэша размером size файлу с
+   * признаками stamp.
+   */
+  static bool matches(const Header &header, const Stamp &stamp,
+                      uint64_t size) noexcept;
+
+  /**
+   * @brief Удаление давно не использовавшихся файлов кэша сверх limit.
+   *
+   * @param kept Путь к файлу кэша, который не удаляется.
+   */
+  void evict(const std::string &kept) const;
+
+  std::string directory;  ///< Каталог кэша (пустой — кэш отключён).
+  uint64_t limit;         ///< Предел суммарного размера файлов кэша.
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_MESH_CACHE_H_
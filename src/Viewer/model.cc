@@ -1,223 +1,622 @@
 #include "model.h"
 
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+
+#include "bounded_queue.h"
+#include "decompressor.h"
+#include "mapped_file.h"
+#include "mesh_cache.h"
+#include "thread_pool.h"
+
+static_assert(std::is_same<s21::Model::Vertexes::value_type, float>::value &&
+                  s21::Model::Vertexes::layout == s21::VertexLayout::kPacked,
+              "Ядра преобразования работают с упакованными вершинами float");
+
 /**
  * @brief Устанавливает модель в центре виджета и масштабирует её.
  *
- * Функция считает минимальные и максимальные значения координат вершин модели
- * и масштабирует модель так, чтобы она была центрирована и охватывала виджет.
- * Это позволяет отобразить модель в центре виджета с правильным масштабом.
+ * Функция по минимальным и максимальным значениям координат вершин модели
+ * строит матрицу, которая центрирует модель и масштабирует её так, чтобы она
+ * охватывала виджет. Накопленные ранее преобразования сбрасываются.
+ *
+ * @note Функция предполагает, что вершины модели уже загружены.
+ * @note Функция не изменяет вершины и значения min и max координат.
+ */
+void s21::Model::setInCenter() noexcept { viewer.matrix = centering(viewer); }
+
+/**
+ * @brief Строит матрицу, центрирующую и масштабирующую модель.
+ *
+ * Центр ограничивающего параллелепипеда переносится в начало координат, а
+ * наибольший его размер масштабируется до 3 (от -1.5 до 1.5). Пустая или
+ * вырожденная в точку модель не масштабируется.
  *
- * @note Функция предполагает, что матрица вершин модели уже содержит данные.
- * @note Функция не изменяет значения min и max координат.
+ * @param data Данные модели с вычисленными границами.
+ * @return Матрица центрирования.
  */
-void s21::Model::setInCenter() const noexcept {
+s21::TransformMatrix s21::Model::centering(const Data &data) noexcept {
   // Вычисляем масштаб для центрирования модели и охвата виджета
-  double zoom = (1.5 - (1.5 * (-1))) / fmax(fmax((viewer.maxX - viewer.minX),
-                                                 (viewer.maxY - viewer.minY)),
-                                            (viewer.maxZ - viewer.minZ));
+  double extent = fmax(fmax((data.maxX - data.minX), (data.maxY - data.minY)),
+                       (data.maxZ - data.minZ));
+  if (!(extent > 0)) return TransformMatrix::identity();
+  double zoom = (1.5 - (1.5 * (-1))) / extent;
 
   // Вычисляем центр модели
-  double center_x = viewer.minX + (viewer.maxX - viewer.minX) / 2.0;
-  double center_y = viewer.minY + (viewer.maxY - viewer.minY) / 2.0;
-  double center_z = viewer.minZ + (viewer.maxZ - viewer.minZ) / 2.0;
-
-  // Применяем масштаб и центрируем модель
-  for (unsigned int i = 1; i <= viewer.count_of_vertexes; i++) {
-    viewer.matrix_of_vertexes.matrix[i][0] =
-        (viewer.matrix_of_vertexes.matrix[i][0] - center_x) * zoom;
-    viewer.matrix_of_vertexes.matrix[i][1] =
-        (viewer.matrix_of_vertexes.matrix[i][1] - center_y) * zoom;
-    viewer.matrix_of_vertexes.matrix[i][2] =
-        (viewer.matrix_of_vertexes.matrix[i][2] - center_z) * zoom;
-  }
+  double center_x = data.minX + (data.maxX - data.minX) / 2.0;
+  double center_y = data.minY + (data.maxY - data.minY) / 2.0;
+  double center_z = data.minZ + (data.maxZ - data.minZ) / 2.0;
+
+  // Сначала сдвигаем центр в начало координат, затем масштабируем
+  return TransformMatrix::scaling(zoom) *
+         TransformMatrix::translation(-center_x, -center_y, -center_z);
 }
 
 /**
  * @brief Инициализирует переменные структур класса Model.
  *
  * Эта функция устанавливает начальные значения переменных в классе Model
- * перед началом работы с моделью. Она обнуляет счетчики полигонов и вершин,
- * а также устанавливает указатели на матрицу вершин и массив полигонов в
- * nullptr. Координаты минимума и максимума по осям X, Y и Z устанавливаются в
- * исключительные значения, чтобы в будущем их можно было корректно обновить при
- * анализе модели.
+ * перед началом работы с моделью: обнуляет счетчики, освобождает вершины и
+ * полигоны, а координаты минимума и максимума по осям X, Y и Z устанавливает в
+ * исключительные значения, чтобы в будущем их можно было корректно обновить
+ * при анализе модели.
  */
 void s21::Model::initialize() noexcept {
-  viewer.count_of_polygons = 0;
-  viewer.count_of_vertexes = 0;
-  viewer.matrix_of_vertexes.columns = 0;
-  viewer.matrix_of_vertexes.rows = 0;
-  viewer.matrix_of_vertexes.matrix = nullptr;
-  viewer.array_of_polygon = nullptr;
-  viewer.minX = DBL_MAX;
-  viewer.minY = DBL_MAX;
-  viewer.minZ = DBL_MAX;
-  viewer.maxX = DBL_MIN;
-  viewer.maxY = DBL_MIN;
-  viewer.maxZ = DBL_MIN;
+  finishCacheStore();
+  viewer = Data();
+  geometry_revision++;
 }
 
 /**
- * @brief Первичное считывание модели из файла .obj для подсчета вершин и
- * полигонов.
+ * @brief Загрузка модели из файла .obj за один проход.
  *
- * Функция открывает файл модели .obj и проходит по его строкам, подсчитывая
- * количество вершин и полигонов. Это первичное считывание модели, которое
- * позволяет узнать количество элементов для дальнейшего выделения памяти и
- * считывания полной модели.
+ * Функция сбрасывает состояние модели, отображает файл в память и разбирает
+ * его содержимое одним последовательным проходом. Если файл не удалось
+ * открыть, модель остаётся пустой.
  *
  * @param file_name Путь к файлу .obj модели для считывания.
+ */
+void s21::Model::coreParser(const char *file_name) noexcept {
+  initialize();
+  if (load(file_name, viewer)) storeCache(file_name);
+}
+
+/**
+ * @brief Загружает модель из файла .obj в отдельные данные.
  *
- * @note Функция не загружает полную модель, а только считает количество вершин
- * и полигонов. Для полной загрузки и анализа модели используйте функцию
- * secondReadParser.
- */
-void s21::Model::firstReadParser(const char *file_name) noexcept {
-  std::ifstream f(file_name);
-  std::string line;
-  if (f.is_open())
-    while (std::getline(f, line)) {
-      if (line.compare(0, 2, "v ") == 0) viewer.count_of_vertexes++;
-      if (line.compare(0, 2, "f ") == 0) viewer.count_of_polygons++;
-    }
+ * Файл отображается в память и разбирается так же, как в coreParser(), но
+ * результат записывается в data, а экземпляр модели не изменяется. Поэтому
+ * несколько файлов можно разбирать одновременно из разных потоков.
+ *
+ * @param file_name Путь к файлу .obj.
+ * @param data Данные, заменяемые результатом разбора.
+ * @param threads Количество потоков разбора (см. setParserThreads()).
+ * @param progress Если не nullptr, ход разбора и запрос отмены.
+ * @return true, если файл удалось открыть и разбор не был отменён. После
+ * отмены data остаётся пустой.
+ */
+bool s21::Model::parseFile(const char *file_name, Data &data,
+                           unsigned int threads, Progress *progress) {
+  data = Data();
+  bool parsed = false;
+  if (Decompressor::detect(file_name) != Decompressor::Format::kNone) {
+    Decompressor input(file_name);
+    if (!input.isOpen()) return false;
+    parsed = parseStream(input, data, threads, progress);
+  } else {
+    MappedFile file(file_name);
+    if (!file.isOpen()) return false;
+    if (progress) progress->total = file.size();
+    parsed = parseBuffer(file.begin(), file.end(), data, threads, progress);
+  }
+  if (!parsed) data = Data();
+  return parsed;
+}
+
+/**
+ * @brief Загружает модель из кэша или разбирает файл .obj.
+ *
+ * Кэш проверяется до открытия файла .obj, поэтому при попадании файл модели
+ * не читается целиком. Разобранная модель в кэш не записывается (см.
+ * storeCache()).
+ *
+ * @param file_name Путь к файлу .obj.
+ * @param data Данные, заменяемые загруженной моделью.
+ * @param threads Количество потоков разбора (см. setParserThreads()).
+ * @param cache_directory Каталог кэша; пустая строка — без кэша.
+ * @param progress Если не nullptr, ход загрузки и запрос отмены.
+ * @return true, если модель загружена из кэша или файл удалось открыть,
+ * и загрузка не была отменена.
+ */
+bool s21::Model::loadFile(const char *file_name, Data &data,
+                          unsigned int threads,
+                          const std::string &cache_directory,
+                          Progress *progress) {
+  MeshCache cache(cache_directory);
+  uint64_t size = 0;
+  if (cache.load(file_name, data, &size)) {
+    if (!progress) return true;
+    progress->vertexes = data.count_of_vertexes;
+    progress->polygons = data.count_of_polygons;
+    progress->total = progress->bytes = size;
+    return true;
+  }
+  return parseFile(file_name, data, threads, progress);
+}
+
+/**
+ * @brief Сохраняет данные модели в кэш в пуле потоков.
+ *
+ * Предыдущая запись отменяется и дожидается, поэтому в любой момент идёт
+ * не больше одной записи, и флаг отмены у них общий. Ошибка записи кэша
+ * (например, каталог недоступен) не влияет на модель.
+ *
+ * @param file_name Путь к файлу .obj, из которого загружены данные.
+ * @return Окончание записи; недействительно, если кэш не используется.
+ */
+std::shared_future<void> s21::Model::storeCache(const char *file_name) {
+  finishCacheStore();
+  if (cache_directory.empty()) return cache_store;
+  cache_store_cancelled = false;
+  cache_store =
+      ThreadPool::getInstance()
+          .submit([this, cache = MeshCache(cache_directory),
+                   source = std::string(file_name)] {
+            if (!cache.isCurrent(source.c_str()))
+              cache.store(source.c_str(), viewer, &cache_store_cancelled);
+          })
+          .share();
+  return cache_store;
+}
 
-  f.close();
+/**
+ * @brief Отменяет запись данных модели в кэш и дожидается её.
+ */
+void s21::Model::finishCacheStore() noexcept {
+  if (!cache_store.valid()) return;
+  cache_store_cancelled = true;
+  cache_store.wait();
+  cache_store = std::shared_future<void>();
 }
 
 /**
- * @brief Вторичное считывание модели из файла .obj для полной загрузки данных
- * модели.
+ * @brief Разбор содержимого файла .obj.
  *
- * Функция открывает файл модели .obj и проходит по его строкам, считывая данные
- * о вершинах и полигонах модели. Это вторичное считывание модели, которое
- * выполняется после подсчета количества вершин и полигонов в модели функцией
- * firstReadParser. Функция считывает координаты вершин, их нормали и связи для
- * полигонов.
+ * Функция делит буфер на части по границам строк (количество частей задаётся
+ * параметром threads), разбирает части в пуле потоков и собирает результат.
+ * Для одной части слияние сводится к перемещению её данных в модель.
  *
- * @param file_name Путь к файлу .obj модели для считывания данных.
+ * @param begin Начало буфера.
+ * @param end Конец буфера.
+ * @param data Данные, в которые записывается результат.
+ * @param threads Количество потоков разбора (см. setParserThreads()).
+ * @param progress Ход разбора или nullptr.
+ * @return false, если разбор был отменён; части при этом не сливаются.
+ */
+bool s21::Model::parseBuffer(const char *begin, const char *end, Data &data,
+                             unsigned int threads, Progress *progress) {
+  std::vector<Chunk> chunks;
+  splitChunks(begin, end, threads, progress, chunks);
+  ThreadPool::getInstance().parallelFor(
+      chunks.size(), [&chunks](std::size_t c) { parseChunk(chunks[c]); });
+  if (progress && progress->cancelled) return false;
+  mergeChunks(chunks, data);
+  buildEdges(data);
+  return true;
+}
+
+/**
+ * @brief Разбор сжатого файла одновременно с распаковкой.
  *
- * @note Функция выполняет полную загрузку данных модели из файла .obj.
- * Для последующей работы с моделью используйте эту функцию после вызова
- * firstReadParser.
+ * Распаковка обычно медленнее разбора, поэтому разбор блока в пуле потоков
+ * полностью перекрывается распаковкой следующего, а очередь ограниченного
+ * размера не даёт распакованным данным копиться в памяти. Ход загрузки по
+ * байтам ведёт поток распаковки в сжатых байтах, а части блоков сообщают
+ * только количество вершин и полигонов.
  */
-void s21::Model::secondReadParser(const char *file_name) noexcept {
-  std::ifstream f(file_name);
-  std::string line;
-  if (f.is_open()) {
-    int i = 1, j = 1;
+bool s21::Model::parseStream(Decompressor &input, Data &data,
+                             unsigned int threads, Progress *progress) {
+  if (progress) progress->total = input.size();
+  BoundedQueue<std::vector<char>> blocks(kStreamBlocks);
+  std::thread reader([&input, &blocks, progress]() {
+    for (;;) {
+      std::vector<char> block(kStreamBlock);
+      block.resize(input.read(block.data(), block.size()));
+      if (progress) progress->bytes = input.consumed();
+      if (block.empty() || !blocks.push(std::move(block))) break;
+    }
+    blocks.close();
+  });
 
-    while (std::getline(f, line)) {
-      if (line.compare(0, 2, "v ") == 0) {
-        char ch;
-        sscanf(line.c_str(), "%c %lf %lf %lf", &ch,
-               &viewer.matrix_of_vertexes.matrix[i][0],
-               &viewer.matrix_of_vertexes.matrix[i][1],
-               &viewer.matrix_of_vertexes.matrix[i][2]);
-        minMax(i);
-        i++;
-      }
+  ThreadPool &pool = ThreadPool::getInstance();
+  std::vector<Chunk> chunks;
+  std::vector<char> text, block;
+  for (bool more = true; more && !(progress && progress->cancelled);) {
+    more = blocks.pop(block);
+    if (more) text.insert(text.end(), block.begin(), block.end());
+    const char *begin = text.data(), *end = begin + text.size();
+    while (more && end != begin && end[-1] != '\n') end--;
+    if (end == begin && more) continue;
 
-      if (line.compare(0, 2, "f ") == 0) {
-        countVertexesForPolygon(const_cast<char *>(line.c_str()), j);
-        vertexesForPolygonMemoryAllocation(j);
-        parserVertexesForPolygon(const_cast<char *>(line.c_str()), j);
-        j++;
-      }
+    std::size_t first = chunks.size();
+    splitChunks(begin, end, threads, progress, chunks);
+    for (std::size_t c = first; c < chunks.size(); c++)
+      chunks[c].streamed = true;
+    pool.parallelFor(chunks.size() - first, [&chunks, first](std::size_t c) {
+      parseChunk(chunks[first + c]);
+    });
+    text.erase(text.begin(), text.begin() + (end - begin));
+  }
+  blocks.close();
+  reader.join();
+
+  if (input.failed() || (progress && progress->cancelled)) return false;
+  mergeChunks(chunks, data);
+  buildEdges(data);
+  return true;
+}
+
+/**
+ * @brief Делит буфер по границам строк на части для разбора.
+ *
+ * Границы частей сдвигаются от равных долей буфера вперёд до ближайшего
+ * перевода строки, поэтому каждая строка целиком попадает в одну часть.
+ */
+void s21::Model::splitChunks(const char *begin, const char *end,
+                             unsigned int threads, Progress *progress,
+                             std::vector<Chunk> &chunks) {
+  std::size_t size = end - begin;
+  std::size_t count = threads;
+  if (count == 0)
+    count = std::max<std::size_t>(
+        1, std::min<std::size_t>(ThreadPool::getInstance().concurrency(),
+                                 size / kMinChunkSize));
+
+  const char *p = begin;
+  for (std::size_t c = 0; c < count; c++) {
+    Chunk chunk;
+    chunk.begin = p;
+    if (c + 1 < count && p < begin + size * (c + 1) / count) {
+      p = begin + size * (c + 1) / count;
+      const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+      p = eol ? eol + 1 : end;
+    } else if (c + 1 == count) {
+      p = end;
     }
+    chunk.end = p;
+    chunk.progress = progress;
+    chunks.push_back(std::move(chunk));
   }
-  f.close();
 }
 
 /**
- * @brief Парсинг строковых данных полигона для получения вершин полигона.
+ * @brief Строит список уникальных рёбер модели.
  *
- * Функция разбирает строку данных полигона, извлекая индексы вершин, связанных
- * с этим полигоном. Полученные индексы вершин сохраняются в массиве структуры,
- * представляющей полигон. Эта функция используется при вторичном считывании
- * модели из файла .obj.
+ * Сортировка ключей выполняется за O(E log E) без хеш-таблицы и отдельной
+ * аллокации на ребро; результат упорядочен по первой вершине, что улучшает
+ * локальность обращений к буферу вершин при отрисовке.
+ */
+void s21::Model::buildEdges(Data &data) {
+  const Faces &faces = data.faces;
+  const uint32_t vertexes = static_cast<uint32_t>(data.vertexes.size());
+  std::vector<uint64_t> keys;
+  keys.reserve(faces.indexes.size());
+  for (uint32_t i = 0; i < faces.size(); i++) {
+    const uint32_t *first = faces.begin(i), *last = faces.end(i);
+    for (const uint32_t *v = first; v != last; v++) {
+      uint32_t a = *v, b = v + 1 != last ? v[1] : *first;
+      if (a == b || a >= vertexes || b >= vertexes) continue;
+      if (a > b) std::swap(a, b);
+      keys.push_back(static_cast<uint64_t>(a) << 32 | b);
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  data.edges.resize(keys.size() * 2);
+  for (std::size_t e = 0; e < keys.size(); e++) {
+    data.edges[e * 2] = static_cast<uint32_t>(keys[e] >> 32);
+    data.edges[e * 2 + 1] = static_cast<uint32_t>(keys[e]);
+  }
+  data.count_of_edges = static_cast<unsigned int>(keys.size());
+}
+
+/**
+ * @brief Разбор одной части файла за один проход.
  *
- * @param str Строковое представление полигона для разбора.
- * @param j Индекс полигона в массиве полигонов модели.
+ * Функция проходит по части построчно. Строки вершин ("v ") разбираются
+ * собственным парсером чисел, индексы строк полигонов ("f ") дописываются в
+ * массив индексов полигонов без копирования строки. Остальные строки
+ * пропускаются. Ход разбора публикуется приращениями, поэтому счётчики
+ * частей, разбираемых параллельно, складываются без блокировок.
  *
- * @note Функция предназначена для внутреннего использования и обычно вызывается
- * внутри функции secondReadParser.
+ * @param chunk Часть файла.
  */
-void s21::Model::parserVertexesForPolygon(char *str, int j) {
-  char *tmp = new char[strlen(str) + 1];
+void s21::Model::parseChunk(Chunk &chunk) {
+  const char *p = chunk.begin;
+  const char *end = chunk.end;
+  const char *reported = p;
+  std::size_t reported_vertexes = 0, reported_polygons = 0;
+  // Публикация разобранного с прошлого вызова; false — запрошена отмена
+  auto report = [&]() {
+    Progress &progress = *chunk.progress;
+    if (!chunk.streamed) progress.bytes += p - reported;
+    progress.vertexes += chunk.data.vertexes.size() - reported_vertexes;
+    progress.polygons += chunk.data.faces.size() - reported_polygons;
+    if (progress.publish)
+      publishPreview(progress, chunk.data, reported_vertexes);
+    reported = p;
+    reported_vertexes = chunk.data.vertexes.size();
+    reported_polygons = chunk.data.faces.size();
+    return !progress.cancelled;
+  };
+  while (p < end) {
+    if (chunk.progress &&
+        static_cast<std::size_t>(p - reported) >= kProgressStep && !report())
+      return;
+    const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+    if (!eol) eol = end;
 
-  if (tmp) {
-    strncpy(tmp, str, strlen(str) + 1);
-    char *sep_str = strtok(tmp, " ");
-    int e = 0;
-    unsigned int vertex = 0;
-
-    while (sep_str != NULL) {
-      if ((vertex = atof(sep_str)) != 0) {
-        viewer.array_of_polygon[j].vertexes[e] = vertex;
-        e++;
+    if (eol - p >= 2 && (p[1] == ' ' || p[1] == '\t')) {
+      if (p[0] == 'v') {
+        parseVertex(chunk, p + 1, eol);
+      } else if (p[0] == 'f') {
+        parserVertexesForPolygon(chunk, p + 1, eol);
       }
-      sep_str = strtok(NULL, " ");
     }
-    delete[] tmp;
+    p = eol + 1;
   }
+  p = end;
+  if (chunk.progress) report();
+  chunk.data.count_of_polygons = chunk.data.faces.size();
 }
 
 /**
- * @brief Подсчет количества вершин в полигоне.
+ * @brief Публикует вершины части для предпросмотра.
  *
- * Функция анализирует строковое представление полигона и определяет
- * количество вершин, связанных с этим полигоном. Полученное количество
- * сохраняется в соответствующем поле структуры, представляющей полигон.
- * Эта функция используется при вторичном считывании модели из файла .obj.
+ * Вершины частей дописываются в общий буфер в порядке публикации, а не в
+ * порядке файла: для отображения точками порядок не важен. Границы части
+ * ведутся по всем её вершинам, поэтому центрирование предпросмотра
+ * учитывает и вершины сверх kPreviewVertexes.
+ */
+void s21::Model::publishPreview(Progress &progress, const Data &data,
+                                std::size_t first) {
+  constexpr std::size_t stride = Vertexes::stride();
+  std::lock_guard<std::mutex> lock(progress.preview_mutex);
+  Data &preview = progress.preview;
+  std::size_t size = preview.vertexes.size();
+  std::size_t count =
+      std::min(data.vertexes.size() - first, kPreviewVertexes - size);
+  preview.vertexes.resize(size + count);
+  std::copy(data.vertexes.data() + first * stride,
+            data.vertexes.data() + (first + count) * stride,
+            preview.vertexes.data() + size * stride);
+  preview.count_of_vertexes = static_cast<unsigned int>(size + count);
+  preview.minX = fmin(preview.minX, data.minX);
+  preview.minY = fmin(preview.minY, data.minY);
+  preview.minZ = fmin(preview.minZ, data.minZ);
+  preview.maxX = fmax(preview.maxX, data.maxX);
+  preview.maxY = fmax(preview.maxY, data.maxY);
+  preview.maxZ = fmax(preview.maxZ, data.maxZ);
+  progress.preview_revision++;
+}
+
+/**
+ * @brief Копирует вершины, уже разобранные фоновой загрузкой.
  *
- * @param str Строковое представление полигона для анализа.
- * @param j Индекс полигона в массиве полигонов модели.
+ * Под блокировкой копируются только вершины, опубликованные с прошлого
+ * вызова, поэтому потоки разбора ждут не дольше копирования одной порции.
+ */
+bool s21::Model::copyPreview(Progress &progress, Data &preview) {
+  constexpr std::size_t stride = Vertexes::stride();
+  std::lock_guard<std::mutex> lock(progress.preview_mutex);
+  if (progress.preview_revision == progress.shown_revision) return false;
+  const Data &published = progress.preview;
+  std::size_t shown = preview.vertexes.size();
+  std::size_t size = published.vertexes.size();
+  preview.vertexes.resize(size);
+  std::copy(published.vertexes.data() + shown * stride,
+            published.vertexes.data() + size * stride,
+            preview.vertexes.data() + shown * stride);
+  preview.count_of_vertexes = published.count_of_vertexes;
+  preview.minX = published.minX, preview.minY = published.minY;
+  preview.minZ = published.minZ;
+  preview.maxX = published.maxX, preview.maxY = published.maxY;
+  preview.maxZ = published.maxZ;
+  preview.matrix = centering(preview);
+  progress.shown_revision = progress.preview_revision;
+  return true;
+}
+
+/**
+ * @brief Слияние разобранных частей в данные модели.
  *
- * @note Функция предназначена для внутреннего использования и обычно вызывается
- * внутри функции secondReadParser.
+ * Префиксные суммы количества вершин, индексов и полигонов частей дают
+ * смещения каждой части в общих массивах, после чего части копируются
+ * параллельно: к смещениям полигонов прибавляется число индексов предыдущих
+ * частей, а к относительным индексам вершин — число вершин предыдущих частей.
+ *
+ * @param chunks Разобранные части в порядке следования в файле.
+ * @param result Данные, в которые записывается результат.
  */
-void s21::Model::countVertexesForPolygon(char *str, int j) {
-  char *tmp = new char[strlen(str) + 1];
+void s21::Model::mergeChunks(std::vector<Chunk> &chunks, Data &result) {
+  if (chunks.size() == 1) {
+    result = std::move(chunks[0].data);
+    return;
+  }
+
+  std::vector<std::size_t> first_vertex(chunks.size() + 1, 0);
+  std::vector<std::size_t> first_index(chunks.size() + 1, 0);
+  std::vector<std::size_t> first_polygon(chunks.size() + 1, 0);
+  for (std::size_t c = 0; c < chunks.size(); c++) {
+    const Data &data = chunks[c].data;
+    first_vertex[c + 1] = first_vertex[c] + data.vertexes.size();
+    first_index[c + 1] = first_index[c] + data.faces.indexes.size();
+    first_polygon[c + 1] = first_polygon[c] + data.faces.size();
+    result.minX = fmin(result.minX, data.minX);
+    result.minY = fmin(result.minY, data.minY);
+    result.minZ = fmin(result.minZ, data.minZ);
+    result.maxX = fmax(result.maxX, data.maxX);
+    result.maxY = fmax(result.maxY, data.maxY);
+    result.maxZ = fmax(result.maxZ, data.maxZ);
+  }
 
-  if (tmp) {
-    strncpy(tmp, str, strlen(str) + 1);
-    char *sep_str = strtok(tmp, " ");
-    unsigned int count = 0;
+  result.vertexes.resize(first_vertex.back());
+  result.faces.indexes.resize(first_index.back());
+  result.faces.offsets.resize(first_polygon.back() + 1);
+  result.count_of_vertexes = static_cast<unsigned int>(first_vertex.back());
+  result.count_of_polygons = static_cast<unsigned int>(first_polygon.back());
 
-    while (sep_str != NULL) {
-      count++;
-      sep_str = strtok(NULL, " ");
+  ThreadPool::getInstance().parallelFor(chunks.size(), [&](std::size_t c) {
+    Data &data = chunks[c].data;
+    result.vertexes.copy(data.vertexes, first_vertex[c]);
+
+    uint32_t *indexes = result.faces.indexes.data() + first_index[c];
+    std::copy(data.faces.indexes.begin(), data.faces.indexes.end(), indexes);
+    uint32_t vertex_base = static_cast<uint32_t>(first_vertex[c]);
+    for (uint32_t position : chunks[c].relative)
+      indexes[position] += vertex_base;
+
+    uint32_t index_base = static_cast<uint32_t>(first_index[c]);
+    uint32_t *offsets = result.faces.offsets.data() + first_polygon[c];
+    for (std::size_t i = 1; i < data.faces.offsets.size(); i++)
+      offsets[i] = data.faces.offsets[i] + index_base;
+
+    data = Data();
+  });
+}
+
+/**
+ * @brief Разбор строки вершины.
+ *
+ * Функция разбирает три координаты, добавляет вершину в хранилище вершин
+ * части и обновляет её границы.
+ *
+ * @param chunk Часть файла, в которую добавляется вершина.
+ * @param p Позиция сразу после символа 'v'.
+ * @param end Конец строки.
+ */
+void s21::Model::parseVertex(Chunk &chunk, const char *p, const char *end) {
+  double coords[3];
+  for (double &c : coords) p = parseDouble(p, end, c);
+  chunk.data.vertexes.push_back(static_cast<float>(coords[0]),
+                                static_cast<float>(coords[1]),
+                                static_cast<float>(coords[2]));
+  minMax(chunk.data, chunk.data.count_of_vertexes++);
+}
+
+/**
+ * @brief Разбор вещественного числа.
+ *
+ * Функция накапливает до 19 значащих цифр мантиссы в целом числе и
+ * масштабирует результат табличной степенью десяти, что даёт точность,
+ * достаточную для координат вершин, без обращения к strtod/sscanf.
+ *
+ * @param p Начало числа.
+ * @param end Конец строки.
+ * @param value Результат разбора (0, если число отсутствует).
+ * @return Позиция сразу после числа.
+ */
+const char *s21::Model::parseDouble(const char *p, const char *end,
+                                    double &value) noexcept {
+  static const double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                  1e18, 1e19, 1e20, 1e21, 1e22};
+  while (p < end && (*p == ' ' || *p == '\t')) p++;
+
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+  unsigned long long mantissa = 0;
+  int digits = 0, exponent = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; p++) {
+    if (digits < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      if (mantissa) digits++;
+    } else {
+      exponent++;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        if (mantissa) digits++;
+        exponent--;
+      }
+    }
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char *q = p + 1;
+    bool exp_negative = false;
+    if (q < end && (*q == '-' || *q == '+')) exp_negative = *q++ == '-';
+    if (q < end && *q >= '0' && *q <= '9') {
+      int e = 0;
+      for (; q < end && *q >= '0' && *q <= '9'; q++)
+        if (e < 10000) e = e * 10 + (*q - '0');
+      exponent += exp_negative ? -e : e;
+      p = q;
     }
+  }
 
-    viewer.array_of_polygon[j].numbers_of_vertexes_for_polygon = count - 1;
-    delete[] tmp;
+  double result = static_cast<double>(mantissa);
+  if (mantissa != 0) {
+    while (exponent > 22) result *= kPow10[22], exponent -= 22;
+    while (exponent < -22) result /= kPow10[22], exponent += 22;
+    result = exponent < 0 ? result / kPow10[-exponent]
+                          : result * kPow10[exponent];
   }
+  value = negative ? -result : result;
+  return p;
 }
 
 /**
- * @brief Создание матрицы вершин модели.
+ * @brief Парсинг строковых данных полигона для получения вершин полигона.
+ *
+ * Функция разбирает строку полигона прямо в буфере файла: каждый токен
+ * вида "v", "v/vt", "v//vn" или "v/vt/vn" даёт индекс вершины, остальная часть
+ * токена пропускается. Отрицательные индексы отсчитываются от последней
+ * разобранной в части вершины и запоминаются в chunk.relative для поправки
+ * при слиянии частей, токены с нулевым индексом игнорируются. Индексы
+ * переводятся в нумерацию с нуля и дописываются в массив индексов полигонов,
+ * поэтому разбор полигона не выделяет память, кроме редкого геометрического
+ * роста массива.
  *
- * Функция создает двумерный массив, представляющий матрицу вершин модели.
- * Эта матрица будет использоваться для хранения координат вершин модели.
- * Количество строк в матрице равно количеству вершин модели плюс одна, а
- * количество столбцов всегда равно 3, так как каждая вершина имеет три
- * координаты (x, y, z).
+ * @param chunk Часть файла, в которую добавляется полигон.
+ * @param p Позиция сразу после символа 'f'.
+ * @param end Конец строки.
  *
- * @note Матрица вершин будет использоваться для внутреннего хранения данных
- * модели. Для добавления вершин в матрицу и работы с ней используются другие
- * функции.
+ * @note Функция предназначена для внутреннего использования и обычно вызывается
+ * внутри функции parseChunk.
  */
-void s21::Model::createMatrixOfVertexes() {
-  viewer.matrix_of_vertexes.columns = 3;
-  viewer.matrix_of_vertexes.rows = viewer.count_of_vertexes + 1;
-  viewer.matrix_of_vertexes.matrix =
-      new double *[viewer.matrix_of_vertexes.rows];
+void s21::Model::parserVertexesForPolygon(Chunk &chunk, const char *p,
+                                          const char *end) {
+  std::vector<uint32_t> &indexes = chunk.data.faces.indexes;
 
-  if (viewer.matrix_of_vertexes.matrix)
-    for (unsigned int i = 0; i < viewer.matrix_of_vertexes.rows; i++) {
-      viewer.matrix_of_vertexes.matrix[i] =
-          new double[viewer.matrix_of_vertexes.columns];
+  while (p < end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    if (p == end) break;
+
+    bool negative = *p == '-';
+    if (negative || *p == '+') p++;
+    uint32_t index = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+      index = index * 10 + (*p - '0');
+
+    if (negative && index != 0) {
+      // Беззнаковое переполнение здесь намеренно: прибавление числа вершин
+      // предыдущих частей при слиянии возвращает индекс в нужный диапазон.
+      chunk.relative.push_back(static_cast<uint32_t>(indexes.size()));
+      indexes.push_back(chunk.data.count_of_vertexes - index);
+    } else if (index != 0) {
+      indexes.push_back(index - 1);
     }
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r') p++;
+  }
+
+  chunk.data.faces.offsets.push_back(static_cast<uint32_t>(indexes.size()));
 }
 
 /**
@@ -232,21 +631,21 @@ void s21::Model::createMatrixOfVertexes() {
  * повторно инициализировать её с помощью функции initialize().
  */
 void s21::Model::releaseResources() {
-  // Удаление матрицы вершин
-  for (unsigned int i = 0; i < viewer.matrix_of_vertexes.rows; i++)
-    delete[] viewer.matrix_of_vertexes.matrix[i];
-
-  delete[] viewer.matrix_of_vertexes.matrix;
-  viewer.matrix_of_vertexes.columns = 0;
-  viewer.matrix_of_vertexes.rows = 0;
+  finishCacheStore();
 
-  // Удаление массива полигонов
-  for (unsigned int i = 1; i < viewer.count_of_polygons + 1; i++)
-    delete[] viewer.array_of_polygon[i].vertexes;
+  // Удаление вершин
+  viewer.vertexes.clear();
 
-  delete[] viewer.array_of_polygon;
+  // Удаление полигонов
+  viewer.faces.clear();
+  std::vector<uint32_t>().swap(viewer.edges);
 
   // Сброс счетчиков
   viewer.count_of_vertexes = 0;
   viewer.count_of_polygons = 0;
+  viewer.count_of_edges = 0;
+
+  // Сброс матрицы модели
+  viewer.matrix = TransformMatrix::identity();
+  geometry_revision++;
 }
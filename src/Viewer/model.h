@@ -7,13 +7,25 @@
 #ifndef CPP4_3DVIEWER_V2_VIEWER_MODEL_H_
 #define CPP4_3DVIEWER_V2_VIEWER_MODEL_H_
 
+#include <atomic>
 #include <cfloat>
 #include <cmath>
+#include <cstdint>
+#include <cstddef>
 #include <cstring>
-#include <fstream>
+#include <future>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "transform_matrix.h"
+#include "vertex_buffer.h"
 
 namespace s21 {
 
+class Decompressor;
+
 /**
  * @brief Класс модели 3D объекта.
  *
@@ -24,33 +36,105 @@ namespace s21 {
 class Model {
  public:
   /**
-   * @brief Структура, представляющая вершины полигона.
+   * @brief Структура, представляющая полигоны модели в формате CSR.
+   *
+   * Индексы вершин всех полигонов лежат подряд в одном массиве indexes, а
+   * offsets хранит начало каждого полигона: вершины полигона i занимают
+   * диапазон [offsets[i], offsets[i + 1]). Полигоны нумеруются с нуля,
+   * offsets всегда содержит на один элемент больше, чем полигонов, поэтому
+   * вся топология модели может быть скопирована или передана целиком.
    */
-  struct Facets {
-    unsigned int *vertexes;  ///< Массив индексов вершин полигона.
-    unsigned int
-        numbers_of_vertexes_for_polygon;  ///< Количество вершин в полигоне.
+  struct Faces {
+    std::vector<uint32_t> indexes;  ///< Индексы вершин всех полигонов.
+    std::vector<uint32_t> offsets{0};  ///< Начала полигонов в indexes.
+
+    /**
+     * @brief Количество полигонов.
+     */
+    inline uint32_t size() const noexcept {
+      return static_cast<uint32_t>(offsets.size() - 1);
+    }
+
+    /**
+     * @brief Указатель на первый индекс вершины полигона i.
+     */
+    inline const uint32_t *begin(uint32_t i) const noexcept {
+      return indexes.data() + offsets[i];
+    }
+
+    /**
+     * @brief Указатель за последним индексом вершины полигона i.
+     */
+    inline const uint32_t *end(uint32_t i) const noexcept {
+      return indexes.data() + offsets[i + 1];
+    }
+
+    /**
+     * @brief Количество вершин в полигоне i.
+     */
+    inline uint32_t count(uint32_t i) const noexcept {
+      return offsets[i + 1] - offsets[i];
+    }
+
+    /**
+     * @brief Удаление всех полигонов с освобождением памяти.
+     */
+    inline void clear() {
+      std::vector<uint32_t>().swap(indexes);
+      std::vector<uint32_t>{0}.swap(offsets);
+    }
   };
 
   /**
-   * @brief Структура, представляющая матрицу вершин модели.
+   * @brief Хранилище вершин модели.
+   *
+   * Упакованные тройки float: вдвое компактнее double и передаются в OpenGL
+   * без перепаковки. Для других задач VertexBuffer можно инстанцировать с
+   * double и/или размещением VertexLayout::kSoA.
    */
-  struct MatrixStruct {
-    double **matrix;  ///< Двумерный массив вершин модели.
-    unsigned int rows;  ///< Количество строк (вершин) в матрице.
-    unsigned int columns;  ///< Количество столбцов (координат) в матрице.
-  };
+  using Vertexes = VertexBuffer<float, VertexLayout::kPacked>;
 
   /**
    * @brief Структура, содержащая данные модели.
    */
   struct Data {
-    unsigned int count_of_vertexes;  ///< Количество вершин модели.
-    unsigned int count_of_polygons;  ///< Количество полигонов модели.
-    MatrixStruct matrix_of_vertexes;  ///< Матрица вершин модели.
-    Facets *array_of_polygon;  ///< Массив полигонов модели.
-    double minX, minY, minZ;  ///< Минимальные координаты модели.
-    double maxX, maxY, maxZ;  ///< Максимальные координаты модели.
+    unsigned int count_of_vertexes = 0;  ///< Количество вершин модели.
+    unsigned int count_of_polygons = 0;  ///< Количество полигонов модели.
+    unsigned int count_of_edges = 0;  ///< Количество уникальных рёбер модели.
+    Vertexes vertexes;  ///< Вершины модели.
+    Faces faces;  ///< Полигоны модели (индексы вершин нумеруются с нуля).
+    std::vector<uint32_t> edges;  ///< Уникальные рёбра: пары индексов вершин.
+    double minX = DBL_MAX, minY = DBL_MAX,
+           minZ = DBL_MAX;  ///< Минимальные координаты модели.
+    double maxX = -DBL_MAX, maxY = -DBL_MAX,
+           maxZ = -DBL_MAX;  ///< Максимальные координаты модели.
+    TransformMatrix matrix;  ///< Матрица модели (накопленные преобразования).
+  };
+
+  /**
+   * @brief Ход загрузки модели, разделяемый с другим потоком.
+   *
+   * Загрузчик увеличивает счётчики по мере разбора, не чаще одного раза на
+   * kProgressStep байт каждой части файла, а другой поток читает их и может
+   * запросить отмену. После успешной загрузки bytes равно total, а
+   * счётчики вершин и полигонов — их количеству в модели.
+   *
+   * Если до начала загрузки задан флаг publish, разбор вместе со счётчиками
+   * дописывает новые вершины в данные preview и объединяет с их границами
+   * границы частей, так что другой поток может показывать модель до
+   * окончания разбора (см. copyPreview()).
+   */
+  struct Progress {
+    std::atomic<uint64_t> bytes{0};      ///< Разобрано байт файла.
+    std::atomic<uint64_t> total{0};      ///< Размер файла в байтах.
+    std::atomic<uint64_t> vertexes{0};   ///< Разобрано вершин.
+    std::atomic<uint64_t> polygons{0};   ///< Разобрано полигонов.
+    std::atomic<bool> cancelled{false};  ///< Запрошена отмена загрузки.
+    bool publish = false;      ///< Публиковать вершины в preview.
+    std::mutex preview_mutex;  ///< Защита preview и preview_revision.
+    Data preview;              ///< Опубликованные вершины и границы.
+    uint64_t preview_revision = 0;  ///< Номер последней публикации.
+    uint64_t shown_revision = 0;  ///< Номер скопированной публикации.
   };
 
   Data viewer;  ///< Данные модели.
@@ -71,27 +155,173 @@ class Model {
   /**
    * @brief Основной метод для загрузки и обработки модели.
    *
-   * Этот метод загружает модель из файла формата .obj и выполняет все
-   * необходимые операции для её обработки, включая инициализацию, аллокацию
-   * памяти и парсинг данных.
+   * Этот метод загружает модель из файла формата .obj за один
+   * последовательный проход: файл отображается в память, строки разбираются
+   * на месте, а хранилища вершин и полигонов растут геометрически. Большие
+   * файлы делятся по границам строк на части, которые разбираются
+   * параллельно (см. setParserThreads()). Если задан каталог кэша (см.
+   * setCacheDirectory()), модель загружается через кэш.
    *
    * @param file_name Путь к файлу .obj, содержащему модель.
    */
-  inline void coreParser(const char *file_name) noexcept {
-    initialize();
-    firstReadParser(file_name);
-    createMatrixOfVertexes();
-    polygonMemoryAllocation();
-    secondReadParser(file_name);
+  void coreParser(const char *file_name) noexcept;
+
+  /**
+   * @brief Загрузка модели из файла .obj в отдельные данные.
+   *
+   * Не изменяет экземпляр модели и может вызываться одновременно из разных
+   * потоков, например для пакетной обработки файлов. Файл, сжатый gzip или
+   * zstd (см. Decompressor), распаковывается потоково, одновременно с
+   * разбором; Progress::bytes и total тогда считаются в сжатых байтах.
+   *
+   * @param file_name Путь к файлу .obj.
+   * @param data Данные, заменяемые результатом разбора.
+   * @param threads Количество потоков разбора (см. setParserThreads()).
+   * @param progress Если не nullptr, ход разбора и запрос отмены.
+   * @return true, если файл удалось открыть и разбор не был отменён.
+   */
+  static bool parseFile(const char *file_name, Data &data,
+                        unsigned int threads = 0,
+                        Progress *progress = nullptr);
+
+  /**
+   * @brief Загрузка модели из двоичного кэша или из файла .obj.
+   *
+   * Если в кэше есть актуальная копия разобранного файла, она загружается
+   * без разбора; иначе файл разбирается parseFile(). Кэш не записывается:
+   * запись копии занимала бы поток загрузки уже после разбора, поэтому
+   * результат сохраняется storeCache() после замены данных модели. Как и
+   * parseFile(), не изменяет экземпляр модели.
+   *
+   * @param file_name Путь к файлу .obj.
+   * @param data Данные, заменяемые загруженной моделью.
+   * @param threads Количество потоков разбора (см. setParserThreads()).
+   * @param cache_directory Каталог кэша (см. MeshCache); пустая строка —
+   * без кэша.
+   * @param progress Если не nullptr, ход загрузки и запрос отмены.
+   * @return true, если модель загружена из кэша или файл удалось открыть,
+   * и загрузка не была отменена.
+   */
+  static bool loadFile(const char *file_name, Data &data,
+                       unsigned int threads,
+                       const std::string &cache_directory,
+                       Progress *progress = nullptr);
+
+  /**
+   * @brief Загрузка модели в отдельные данные с настройками модели.
+   *
+   * Вызывает loadFile() с количеством потоков и каталогом кэша экземпляра.
+   * Экземпляр модели не изменяется, поэтому загрузка может идти в фоновом
+   * потоке, пока отображается и преобразуется прежняя модель; настройки
+   * не должны меняться до её окончания.
+   *
+   * @param file_name Путь к файлу .obj.
+   * @param data Данные, заменяемые загруженной моделью.
+   * @param progress Если не nullptr, ход загрузки и запрос отмены.
+   * @return Результат loadFile().
+   */
+  inline bool load(const char *file_name, Data &data,
+                   Progress *progress = nullptr) const {
+    return loadFile(file_name, data, parser_threads, cache_directory,
+                    progress);
+  }
+
+  /**
+   * @brief Замена данных модели загруженными.
+   *
+   * Данные перемещаются без копирования одним присваиванием, поэтому
+   * отрисовка видит либо прежнюю модель, либо новую целиком.
+   *
+   * Незавершённая запись прежних данных в кэш (см. storeCache()) перед
+   * заменой отменяется.
+   *
+   * @param data Загруженные данные (например, результатом load()).
+   */
+  inline void replace(Data &&data) noexcept {
+    finishCacheStore();
+    viewer = std::move(data);
+    geometry_revision++;
+  }
+
+  /**
+   * @brief Выбор каталога кэша разобранных моделей.
+   *
+   * @param directory Каталог кэша (см. MeshCache::defaultDirectory()); по
+   * умолчанию пустая строка — кэш не используется.
+   */
+  inline void setCacheDirectory(const std::string &directory) {
+    cache_directory = directory;
+  }
+
+  /**
+   * @brief Сохранение данных модели в кэш в пуле потоков.
+   *
+   * Вызывается после замены данных модели загруженными из file_name, чтобы
+   * модель отображалась, не дожидаясь записи копии на диск. Если в кэше уже
+   * есть актуальная копия (модель загружена из него), файл не
+   * перезаписывается. Геометрия модели при записи только читается;
+   * replace(), releaseResources() и coreParser() отменяют незавершённую
+   * запись и дожидаются её, прежде чем изменить данные.
+   *
+   * @param file_name Путь к файлу .obj, из которого загружены данные.
+   * @return Окончание записи; дожидаться его не обязательно.
+   */
+  std::shared_future<void> storeCache(const char *file_name);
+
+  /**
+   * @brief Копирование вершин, уже разобранных фоновой загрузкой.
+   *
+   * Дописывает в preview вершины, опубликованные загрузкой с прошлого
+   * вызова, переносит в него их границы и задаёт матрицу, центрирующую эти
+   * вершины. Данные модели не затрагиваются: они заменяются только
+   * загруженными целиком. Полигоны и рёбра не копируются: индексы вершин
+   * полигонов части файла становятся известны только после слияния частей,
+   * поэтому до окончания загрузки предпросмотр отображается точками.
+   *
+   * @param progress Ход загрузки с флагом publish.
+   * @param preview Данные предпросмотра, пустые до первого вызова.
+   * @return true, если preview изменились.
+   */
+  static bool copyPreview(Progress &progress, Data &preview);
+
+  /**
+   * @brief Выбор количества потоков разбора.
+   *
+   * @param threads 0 — автоматически: по потоку на ядро, но не больше, чем
+   * частей размером kMinChunkSize в файле; 1 — однопоточный разбор; N — файл
+   * делится ровно на N частей независимо от размера.
+   */
+  inline void setParserThreads(unsigned int threads) noexcept {
+    parser_threads = threads;
+  }
+
+  /**
+   * @brief Номер версии геометрии модели.
+   *
+   * Увеличивается при каждом изменении вершин или полигонов (загрузка,
+   * releaseResources()), но не при изменении матрицы модели. Используется
+   * отрисовкой, чтобы загружать геометрию в видеопамять только после её
+   * изменения.
+   */
+  inline uint64_t geometryRevision() const noexcept {
+    return geometry_revision;
   }
 
   /**
    * @brief Установка модели в центр виджета.
    *
-   * Этот метод выполняет установку модели в центр виджета путем масштабирования
-   * и перемещения вершин модели так, чтобы она находилась в центре виджета.
+   * Этот метод записывает в матрицу модели масштабирование и перемещение,
+   * при которых модель находится в центре виджета. Вершины не изменяются.
+   */
+  void setInCenter() noexcept;
+
+  /**
+   * @brief Матрица, помещающая модель с данными data в центр виджета.
+   *
+   * @param data Данные модели с вычисленными границами.
+   * @return Матрица масштабирования и перемещения модели в центр.
    */
-  void setInCenter() const noexcept;
+  static TransformMatrix centering(const Data &data) noexcept;
 
   /**
    * @brief Освобождение ресурсов, связанных с моделью.
@@ -115,26 +345,65 @@ class Model {
 
  private:
   /**
-   * @brief Выделение памяти для массива полигонов.
+   * @brief Минимальный размер части файла при автоматическом выборе
+   * количества потоков разбора.
+   */
+  static constexpr std::size_t kMinChunkSize = 1 << 20;
+
+  /**
+   * @brief Количество байт части файла между обновлениями Progress.
+   */
+  static constexpr std::size_t kProgressStep = 1 << 18;
+
+  /**
+   * @brief Наибольшее количество вершин, публикуемых для предпросмотра.
    *
-   * Этот метод выделяет память для массива полигонов модели.
+   * Ограничивает дополнительную память на время загрузки; границы модели
+   * публикуются и после достижения предела.
    */
-  inline void polygonMemoryAllocation() {
-    viewer.array_of_polygon = new Facets[viewer.count_of_polygons + 1];
-  }
+  static constexpr std::size_t kPreviewVertexes = 1 << 22;
+
+  /**
+   * @brief Размер блока распакованных данных сжатого файла.
+   */
+  static constexpr std::size_t kStreamBlock = 1 << 23;
 
   /**
-   * @brief Выделение памяти для вершин полигона.
+   * @brief Количество распакованных блоков, ожидающих разбора.
+   */
+  static constexpr std::size_t kStreamBlocks = 4;
+
+  /**
+   * @brief Часть файла .obj, разбираемая одним потоком.
    *
-   * Этот метод выделяет память для массива вершин полигона.
+   * Вершины и полигоны части нумеруются локально. Положительные индексы
+   * вершин в файле абсолютны и не требуют поправки, а отрицательные
+   * (относительные) разрешаются от локального счётчика вершин, поэтому их
+   * позиции запоминаются в relative, чтобы при слиянии прибавить к ним число
+   * вершин всех предыдущих частей.
+   */
+  struct Chunk {
+    const char *begin;  ///< Начало части (начало строки).
+    const char *end;  ///< Конец части (после символа перевода строки).
+    Data data;        ///< Разобранные данные части.
+    std::vector<uint32_t> relative;  ///< Позиции относительных индексов.
+    Progress *progress;  ///< Ход разбора или nullptr.
+    bool streamed = false;  ///< Байты учитывает распаковка, а не разбор.
+  };
+
+  unsigned int parser_threads = 0;  ///< Количество потоков разбора.
+  uint64_t geometry_revision = 0;  ///< Номер версии геометрии.
+  std::string cache_directory;  ///< Каталог кэша (пустой — без кэша).
+  std::shared_future<void> cache_store;  ///< Запись данных модели в кэш.
+  std::atomic<bool> cache_store_cancelled{false};  ///< Отмена записи.
+
+  /**
+   * @brief Отмена записи данных модели в кэш и ожидание её окончания.
    *
-   * @param j Индекс полигона, для которого выделяется память.
+   * Запись прекращается на границе ближайшего блока MeshCache::kWriteBlock,
+   * поэтому ожидание не зависит от размера модели.
    */
-  inline void vertexesForPolygonMemoryAllocation(int j) {
-    viewer.array_of_polygon[j].vertexes =
-        new unsigned int[viewer.array_of_polygon[j]
-                             .numbers_of_vertexes_for_polygon];
-  }
+  void finishCacheStore() noexcept;
 
   /**
    * @brief Вычисление минимальных и максимальных координат модели.
@@ -142,38 +411,140 @@ class Model {
    * Этот метод вычисляет минимальные и максимальные координаты модели для
    * определения центра модели и масштабирования.
    *
+   * @param data Данные модели.
    * @param i Индекс вершины модели.
    */
-  inline void minMax(int i) noexcept {
-    viewer.maxX = fmax(viewer.matrix_of_vertexes.matrix[i][0], viewer.maxX);
-    viewer.maxY = fmax(viewer.matrix_of_vertexes.matrix[i][1], viewer.maxY);
-    viewer.maxZ = fmax(viewer.matrix_of_vertexes.matrix[i][2], viewer.maxZ);
-    viewer.minX = fmin(viewer.matrix_of_vertexes.matrix[i][0], viewer.minX);
-    viewer.minY = fmin(viewer.matrix_of_vertexes.matrix[i][1], viewer.minY);
-    viewer.minZ = fmin(viewer.matrix_of_vertexes.matrix[i][2], viewer.minZ);
+  static inline void minMax(Data &data, std::size_t i) noexcept {
+    data.maxX = fmax(data.vertexes.x(i), data.maxX);
+    data.maxY = fmax(data.vertexes.y(i), data.maxY);
+    data.maxZ = fmax(data.vertexes.z(i), data.maxZ);
+    data.minX = fmin(data.vertexes.x(i), data.minX);
+    data.minY = fmin(data.vertexes.y(i), data.minY);
+    data.minZ = fmin(data.vertexes.z(i), data.minZ);
   }
 
-  void countVertexesForPolygon(char *str, int j);
-  void firstReadParser(const char *file_name) noexcept;
-  void secondReadParser(const char *file_name) noexcept;
+  /**
+   * @brief Разбор содержимого файла .obj.
+   *
+   * Этот метод делит буфер по границам строк на части, разбирает их
+   * параллельно и собирает результат в данные модели.
+   *
+   * @param begin Начало буфера.
+   * @param end Конец буфера.
+   * @param data Данные, в которые записывается результат.
+   * @param threads Количество потоков разбора.
+   * @param progress Ход разбора или nullptr.
+   * @return false, если разбор был отменён.
+   */
+  static bool parseBuffer(const char *begin, const char *end, Data &data,
+                          unsigned int threads, Progress *progress);
 
   /**
-   * @brief Создание матрицы вершин модели.
+   * @brief Разбор сжатого файла одновременно с распаковкой.
+   *
+   * Отдельный поток распаковывает файл блоками по kStreamBlock байт и
+   * передаёт их через очередь из kStreamBlocks блоков. Каждый блок до
+   * последнего перевода строки делится на части и разбирается, пока
+   * распаковывается следующий; неполная последняя строка переносится в
+   * следующий блок. Части всех блоков сливаются после окончания файла.
+   *
+   * @param input Открытый сжатый файл.
+   * @param data Данные, в которые записывается результат.
+   * @param threads Количество потоков разбора каждого блока.
+   * @param progress Ход разбора или nullptr.
+   * @return false, если распаковка не удалась или разбор был отменён.
+   */
+  static bool parseStream(Decompressor &input, Data &data,
+                          unsigned int threads, Progress *progress);
+
+  /**
+   * @brief Деление буфера по границам строк на части для разбора.
+   *
+   * @param begin Начало буфера.
+   * @param end Конец буфера (после перевода строки или конец файла).
+   * @param threads Количество частей; 0 — по потоку на ядро, но не больше,
+   * чем частей размером kMinChunkSize.
+   * @param progress Ход разбора или nullptr.
+   * @param chunks Вектор, в конец которого добавляются части.
+   */
+  static void splitChunks(const char *begin, const char *end,
+                          unsigned int threads, Progress *progress,
+                          std::vector<Chunk> &chunks);
+
+  /**
+   * @brief Построение списка уникальных рёбер модели.
+   *
+   * Каждое ребро полигона записывается 64-битным ключом (меньший индекс в
+   * старших битах), ключи сортируются и повторы удаляются, поэтому ребро,
+   * общее для нескольких полигонов, попадает в список один раз. Рёбра с
+   * индексами вне диапазона вершин и вырожденные рёбра пропускаются.
+   *
+   * @param data Данные модели с загруженными полигонами.
+   */
+  static void buildEdges(Data &data);
+
+  /**
+   * @brief Разбор одной части файла за один проход.
+   *
+   * Если задан chunk.progress, разбор прерывается при запросе отмены.
+   *
+   * @param chunk Часть файла.
+   */
+  static void parseChunk(Chunk &chunk);
+
+  /**
+   * @brief Публикация вершин части для предпросмотра.
+   *
+   * @param progress Ход загрузки с флагом publish.
+   * @param data Данные части.
+   * @param first Первая ещё не опубликованная вершина части.
+   */
+  static void publishPreview(Progress &progress, const Data &data,
+                             std::size_t first);
+
+  /**
+   * @brief Слияние разобранных частей в данные модели.
+   *
+   * @param chunks Разобранные части в порядке следования в файле.
+   * @param result Данные, в которые записывается результат.
+   */
+  static void mergeChunks(std::vector<Chunk> &chunks, Data &result);
+
+  /**
+   * @brief Разбор строки вершины.
+   *
+   * @param chunk Часть файла, в которую добавляется вершина.
+   * @param p Позиция сразу после символа 'v'.
+   * @param end Конец строки.
+   */
+  static void parseVertex(Chunk &chunk, const char *p, const char *end);
+
+  /**
+   * @brief Разбор вещественного числа.
+   *
+   * Этот метод разбирает число в десятичной записи (со знаком, дробной частью
+   * и экспонентой) без обращения к libc, пропуская ведущие пробелы.
    *
-   * Этот метод создает двумерную матрицу для хранения вершин модели.
-   * Количество строк и столбцов определяется количеством вершин в модели.
+   * @param p Начало числа.
+   * @param end Конец строки.
+   * @param value Результат разбора.
+   * @return Позиция сразу после числа.
    */
-  void createMatrixOfVertexes();
+  static const char *parseDouble(const char *p, const char *end,
+                                 double &value) noexcept;
 
   /**
    * @brief Парсинг данных полигона.
    *
-   * Этот метод выполняет парсинг данных о вершинах полигона из строки.
+   * Этот метод выполняет парсинг данных о вершинах полигона непосредственно
+   * из буфера файла, дописывая индексы в массив индексов полигонов.
    *
-   * @param str Строка данных о полигоне.
-   * @param j Индекс полигона.
+   * @param chunk Часть файла, в которую добавляется полигон.
+   * @param p Позиция сразу после символа 'f'.
+   * @param end Конец строки.
    */
-  void parserVertexesForPolygon(char *str, int j);
+  static void parserVertexesForPolygon(Chunk &chunk, const char *p,
+                                       const char *end);
 
   /**
    * @brief Инициализация модели.
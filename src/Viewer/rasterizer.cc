@@ -0,0 +1,344 @@
+#include "rasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "thread_pool.h"
+#include "transform_kernels.h"
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr float kCameraDistance = 7;   ///< Сдвиг камеры, как в paintGL().
+constexpr float kHalfSize = 2;         ///< Полуширина объёма видимости.
+constexpr float kCentralNear = 5;      ///< Ближняя плоскость glFrustum().
+constexpr float kParallelNear = 1;     ///< Ближняя плоскость glOrtho().
+constexpr float kFar = 15;             ///< Дальняя плоскость.
+constexpr uint16_t kSolid = 0xFFFF;    ///< Шаблон сплошной линии.
+constexpr uint16_t kDashed = 0x00FF;   ///< Шаблон пунктира из drawLines().
+constexpr float kAxisLength = 2;       ///< Полудлина осей из drawAxis().
+constexpr uint32_t kAxisColor = 0xFFFF00FF;  ///< Цвет осей из drawAxis().
+constexpr std::size_t kVertexAlignment = 16;  ///< Граница блоков вершин.
+
+}  // namespace
+
+/**
+ * @brief Создание буфера пикселей заданного размера.
+ *
+ * Некорректные размеры заменяются на 1.
+ *
+ * @param width Ширина изображения в пикселях.
+ * @param height Высота изображения в пикселях.
+ */
+s21::Rasterizer::Rasterizer(int width, int height)
+    : frame_width(std::max(width, 1)),
+      frame_height(std::max(height, 1)),
+      frame(static_cast<std::size_t>(frame_width) * frame_height) {}
+
+/**
+ * @brief Строит поворот сцены так же, как paintGL().
+ *
+ * glRotatef() по осям X, Y и Z вызываются в paintGL() по очереди, поэтому
+ * итоговая матрица равна Rx * Ry * Rz.
+ */
+s21::TransformMatrix s21::Rasterizer::sceneRotation(double x_angle,
+                                                    double y_angle,
+                                                    double z_angle) noexcept {
+  return TransformMatrix::rotationX(x_angle * kPi / 180) *
+         TransformMatrix::rotationY(y_angle * kPi / 180) *
+         TransformMatrix::rotationZ(z_angle * kPi / 180);
+}
+
+/**
+ * @brief Переводит цвет из RGBA с компонентами от 0 до 1 в 0xAARRGGBB.
+ */
+uint32_t s21::Rasterizer::toArgb(const RenderSettings::Color &color) noexcept {
+  auto channel = [](float c) {
+    return static_cast<uint32_t>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255));
+  };
+  return channel(color.a) << 24 | channel(color.r) << 16 |
+         channel(color.g) << 8 | channel(color.b);
+}
+
+/**
+ * @brief Отрисовка модели.
+ *
+ * Сначала все вершины параллельно переводятся в пространство камеры и
+ * проецируются, затем изображение делится на горизонтальные полосы, каждая
+ * из которых независимо заливается фоном и рисует все рёбра, вершины и оси
+ * в своих границах. Как и в paintGL(), тест глубины не выполняется, вершины
+ * рисуются поверх рёбер, а оси — поверх модели.
+ */
+void s21::Rasterizer::render(const Model::Data &data,
+                             const RenderSettings &settings,
+                             const TransformMatrix &view,
+                             const TransformMatrix &model, bool axes) {
+  projection = settings.projection;
+  const TransformMatrix camera =
+      TransformMatrix::translation(0, 0, -kCameraDistance) * view;
+  projectVertexes(data.vertexes, camera * model);
+
+  ThreadPool &pool = ThreadPool::getInstance();
+  unsigned int tiles =
+      tile_threads
+          ? tile_threads
+          : std::min(pool.concurrency(),
+                     static_cast<unsigned int>(frame_height / kMinTileRows));
+  tiles = std::clamp(tiles, 1u, static_cast<unsigned int>(frame_height));
+  pool.parallelFor(tiles, [&](std::size_t i) {
+    Tile tile{0, static_cast<int>(frame_height * i / tiles), frame_width,
+              static_cast<int>(frame_height * (i + 1) / tiles)};
+    renderTile(tile, data, settings, camera, axes);
+  });
+}
+
+/**
+ * @brief Перевод вершин в пространство камеры и их проецирование.
+ *
+ * Вершины обрабатываются блоками в пуле потоков; границы блоков кратны
+ * ширине векторизованного ядра, чтобы результат не зависел от их числа.
+ */
+void s21::Rasterizer::projectVertexes(const Model::Vertexes &vertexes,
+                                      const TransformMatrix &eye_matrix) {
+  static_assert(sizeof(EyePoint) == 3 * sizeof(float),
+                "EyePoint должен совпадать с упакованной вершиной");
+  const std::size_t count = vertexes.size();
+  eye.resize(count);
+  screen.resize(count);
+
+  ThreadPool &pool = ThreadPool::getInstance();
+  std::size_t blocks = std::max<std::size_t>(
+      1, std::min<std::size_t>(pool.concurrency(), count / kMinVertexBlock));
+  std::size_t block = (count + blocks - 1) / blocks;
+  block = (block + kVertexAlignment - 1) / kVertexAlignment * kVertexAlignment;
+  const float near = nearPlane();
+  pool.parallelFor(blocks, [&](std::size_t b) {
+    std::size_t begin = std::min(count, b * block);
+    std::size_t end = std::min(count, begin + block);
+    float *xyz = reinterpret_cast<float *>(eye.data() + begin);
+    std::copy(vertexes.data() + begin * 3, vertexes.data() + end * 3, xyz);
+    kernels::transform(xyz, end - begin, eye_matrix);
+    for (std::size_t v = begin; v < end; v++) {
+      const EyePoint &p = eye[v];
+      bool visible = -p.z >= near && -p.z <= kFar;
+      screen[v] = visible ? project(p) : ScreenPoint{0, 0, false};
+    }
+  });
+}
+
+/**
+ * @brief Отрисовка одной полосы изображения.
+ *
+ * Рёбра с обеими видимыми вершинами берутся из готовых проекций и
+ * отбрасываются без растеризации, если не пересекают полосу с учётом
+ * толщины; остальные рёбра сначала отсекаются по глубине.
+ */
+void s21::Rasterizer::renderTile(const Tile &tile, const Model::Data &data,
+                                 const RenderSettings &settings,
+                                 const TransformMatrix &axes_matrix,
+                                 bool axes) {
+  const uint32_t background = toArgb(settings.background_color);
+  for (int y = tile.y0; y < tile.y1; y++)
+    std::fill_n(frame.begin() + static_cast<std::size_t>(y) * frame_width,
+                frame_width, background);
+
+  const LineStyle style{
+      toArgb(settings.line_color),
+      std::max(1, static_cast<int>(std::lround(settings.line_width))),
+      settings.line_type == RenderSettings::LineType::kDashed ? kDashed
+                                                              : kSolid};
+  const float margin = style.width * 0.5f + 1;
+  for (std::size_t e = 0; e + 1 < data.edges.size(); e += 2) {
+    uint32_t a = data.edges[e], b = data.edges[e + 1];
+    const ScreenPoint &sa = screen[a], &sb = screen[b];
+    if (sa.visible && sb.visible) {
+      if (std::max(sa.y, sb.y) + margin < tile.y0 ||
+          std::min(sa.y, sb.y) - margin >= tile.y1)
+        continue;
+      drawLine(sa, sb, style, tile);
+    } else {
+      drawEdge(eye[a], eye[b], style, tile);
+    }
+  }
+
+  if (settings.vertex_display != RenderSettings::PointShape::kNone) {
+    const uint32_t color = toArgb(settings.vertex_color);
+    const float radius = settings.vertex_size * 0.5f + 1;
+    for (const ScreenPoint &p : screen) {
+      if (!p.visible || p.y + radius < tile.y0 || p.y - radius >= tile.y1)
+        continue;
+      drawPoint(p, settings.vertex_size, settings.vertex_display, color, tile);
+    }
+  }
+
+  if (axes) {
+    // Оси рисуются после glPopMatrix() с той же толщиной и пунктиром
+    LineStyle axis_style = style;
+    axis_style.color = kAxisColor;
+    for (int axis = 0; axis < 3; axis++) {
+      float from[3] = {0, 0, 0}, to[3] = {0, 0, 0};
+      from[axis] = kAxisLength;
+      to[axis] = -kAxisLength;
+      EyePoint a{from[0], from[1], from[2]}, b{to[0], to[1], to[2]};
+      axes_matrix.apply(a.x, a.y, a.z);
+      axes_matrix.apply(b.x, b.y, b.z);
+      drawEdge(a, b, axis_style, tile);
+    }
+  }
+}
+
+/**
+ * @brief Отрисовка ребра с отсечением по глубине.
+ */
+void s21::Rasterizer::drawEdge(EyePoint a, EyePoint b, const LineStyle &style,
+                               const Tile &tile) noexcept {
+  if (!clipDepth(a, b)) return;
+  drawLine(project(a), project(b), style, tile);
+}
+
+/**
+ * @brief Проецирует точку камеры в координаты изображения.
+ *
+ * Центральная проекция соответствует glFrustum(-2, 2, -2, 2, 5, 15),
+ * параллельная — glOrtho(-2, 2, -2, 2, 1, 15). Нормализованные координаты
+ * [-1, 1] переводятся в пиксели с направленной вниз осью Y.
+ */
+s21::Rasterizer::ScreenPoint s21::Rasterizer::project(
+    const EyePoint &p) const noexcept {
+  float nx, ny;
+  if (projection == RenderSettings::Projection::kCentral) {
+    nx = kCentralNear / kHalfSize * p.x / -p.z;
+    ny = kCentralNear / kHalfSize * p.y / -p.z;
+  } else {
+    nx = p.x / kHalfSize;
+    ny = p.y / kHalfSize;
+  }
+  return {(nx + 1) * 0.5f * frame_width, (1 - ny) * 0.5f * frame_height,
+          true};
+}
+
+/**
+ * @brief Ближняя плоскость текущей проекции.
+ */
+float s21::Rasterizer::nearPlane() const noexcept {
+  return projection == RenderSettings::Projection::kCentral ? kCentralNear
+                                                            : kParallelNear;
+}
+
+/**
+ * @brief Отсекает отрезок ближней и дальней плоскостями.
+ *
+ * Концы, лежащие за плоскостью, переносятся в точку пересечения отрезка с
+ * ней, поэтому центральная проекция никогда не делит на неположительную
+ * глубину.
+ */
+bool s21::Rasterizer::clipDepth(EyePoint &a, EyePoint &b) const noexcept {
+  const float planes[2] = {-nearPlane(), -kFar};
+  for (int i = 0; i < 2; i++) {
+    // Для ближней плоскости видимы точки с z <= -near, для дальней z >= -far
+    float sign = i == 0 ? 1.0f : -1.0f;
+    float da = sign * (planes[i] - a.z), db = sign * (planes[i] - b.z);
+    if (da < 0 && db < 0) return false;
+    if (da < 0 || db < 0) {
+      float t = da / (da - db);
+      EyePoint p{a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, planes[i]};
+      (da < 0 ? a : b) = p;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Рисует отрезок заданной толщины и пунктира.
+ *
+ * Отрезок отсекается прямоугольником tile, расширенным на толщину линии
+ * (Лианг — Барски), и проходится только на видимом участке; номер шага
+ * при этом совпадает с шагом от начала неотсечённого отрезка.
+ */
+void s21::Rasterizer::drawLine(const ScreenPoint &a, const ScreenPoint &b,
+                               const LineStyle &style,
+                               const Tile &tile) noexcept {
+  const float dx = b.x - a.x, dy = b.y - a.y;
+  const float margin = style.width * 0.5f + 1;
+  float t0 = 0, t1 = 1;
+  const float p[4] = {-dx, dx, -dy, dy};
+  const float q[4] = {a.x - (tile.x0 - margin), tile.x1 + margin - a.x,
+                      a.y - (tile.y0 - margin), tile.y1 + margin - a.y};
+  for (int i = 0; i < 4; i++) {
+    if (p[i] == 0) {
+      if (q[i] < 0) return;
+      continue;
+    }
+    float t = q[i] / p[i];
+    if (p[i] < 0)
+      t0 = std::max(t0, t);
+    else
+      t1 = std::min(t1, t);
+    if (t0 > t1) return;
+  }
+
+  const bool x_major = std::fabs(dx) >= std::fabs(dy);
+  const double total = std::ceil(std::max(std::fabs(dx), std::fabs(dy)));
+  const double step_x = total > 0 ? dx / total : 0;
+  const double step_y = total > 0 ? dy / total : 0;
+  const long long first = static_cast<long long>(std::floor(t0 * total));
+  const long long last = static_cast<long long>(std::ceil(t1 * total));
+  const int half = (style.width - 1) / 2;
+  for (long long i = first; i <= last; i++) {
+    if (!(style.pattern >> (i & 15) & 1)) continue;
+    int x = static_cast<int>(std::floor(a.x + step_x * i));
+    int y = static_cast<int>(std::floor(a.y + step_y * i));
+    if (x_major) {
+      if (x < tile.x0 || x >= tile.x1) continue;
+      int y0 = std::max(y - half, tile.y0);
+      int y1 = std::min(y - half + style.width, tile.y1);
+      for (int row = y0; row < y1; row++)
+        frame[static_cast<std::size_t>(row) * frame_width + x] = style.color;
+    } else {
+      fillSpan(y, x - half, x - half + style.width, style.color, tile);
+    }
+  }
+}
+
+/**
+ * @brief Рисует точку размером size пикселей.
+ *
+ * Для квадратных точек закрашиваются пиксели, центры которых попадают в
+ * квадрат со стороной size с центром в точке, как при glPointSize() без
+ * сглаживания; для круглых — пиксели внутри круга диаметром size.
+ */
+void s21::Rasterizer::drawPoint(const ScreenPoint &p, float size,
+                                RenderSettings::PointShape shape,
+                                uint32_t color, const Tile &tile) noexcept {
+  if (shape == RenderSettings::PointShape::kCircle && size >= 2) {
+    const float radius = size * 0.5f;
+    int top = static_cast<int>(std::floor(p.y - radius));
+    int bottom = static_cast<int>(std::ceil(p.y + radius));
+    for (int y = top; y < bottom; y++) {
+      float dy = y + 0.5f - p.y, span = radius * radius - dy * dy;
+      if (span < 0) continue;
+      float half = std::sqrt(span);
+      int x0 = static_cast<int>(std::ceil(p.x - half - 0.5f));
+      int x1 = static_cast<int>(std::floor(p.x + half - 0.5f)) + 1;
+      fillSpan(y, x0, x1, color, tile);
+    }
+    return;
+  }
+  int n = std::max(1, static_cast<int>(std::lround(size)));
+  int left = static_cast<int>(std::floor(p.x - n * 0.5f + 0.5f));
+  int top = static_cast<int>(std::floor(p.y - n * 0.5f + 0.5f));
+  for (int y = top; y < top + n; y++) fillSpan(y, left, left + n, color, tile);
+}
+
+/**
+ * @brief Закрашивает пиксели [x0, x1) строки y в пределах tile.
+ */
+void s21::Rasterizer::fillSpan(int y, int x0, int x1, uint32_t color,
+                               const Tile &tile) noexcept {
+  if (y < tile.y0 || y >= tile.y1) return;
+  x0 = std::max(x0, tile.x0);
+  x1 = std::min(x1, tile.x1);
+  if (x0 < x1)
+    std::fill_n(frame.begin() + static_cast<std::size_t>(y) * frame_width + x0,
+                x1 - x0, color);
+}
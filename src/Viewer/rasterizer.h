@@ -0,0 +1,208 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением класса Rasterizer — программной
+отрисовки каркаса модели в буфер пикселей без OpenGL.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_RASTERIZER_H_
+#define CPP4_3DVIEWER_V2_VIEWER_RASTERIZER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "model.h"
+#include "render_settings.h"
+#include "transform_matrix.h"
+
+namespace s21 {
+
+/**
+ * @brief Программная отрисовка каркаса модели.
+ *
+ * Повторяет конвейер Paint::paintGL() без контекста OpenGL: вершины
+ * переводятся в систему координат камеры (сдвиг на -7 по Z), отсекаются
+ * ближней и дальней плоскостями, проецируются так же, как glFrustum() или
+ * glOrtho() в paintGL(), и рисуются в буфер пикселей в формате 0xAARRGGBB
+ * (совпадает с QImage::Format_ARGB32). Учитываются толщина и пунктир линий,
+ * размер и форма точек. Изображение делится на горизонтальные полосы,
+ * которые рисуются параллельно в пуле потоков. Используется там, где нет
+ * дисплея или графического драйвера.
+ */
+class Rasterizer {
+ public:
+  /**
+   * @brief Создание буфера пикселей заданного размера.
+   *
+   * @param width Ширина изображения в пикселях.
+   * @param height Высота изображения в пикселях.
+   */
+  Rasterizer(int width, int height);
+
+  inline int width() const noexcept { return frame_width; }  ///< Ширина.
+  inline int height() const noexcept { return frame_height; }  ///< Высота.
+
+  /**
+   * @brief Пиксели изображения построчно сверху вниз в формате 0xAARRGGBB.
+   */
+  inline const uint32_t *pixels() const noexcept { return frame.data(); }
+
+  /**
+   * @brief Выбор количества полос, рисуемых параллельно.
+   *
+   * @param threads 0 — автоматически: по полосе на поток пула, но не меньше
+   * kMinTileRows строк в полосе; N — ровно N полос (не больше числа строк).
+   */
+  inline void setThreads(unsigned int threads) noexcept {
+    tile_threads = threads;
+  }
+
+  /**
+   * @brief Отрисовка модели.
+   *
+   * Буфер заливается цветом фона, затем, как в paintGL(), рисуются рёбра
+   * модели, вершины (если включено их отображение) и оси координат.
+   *
+   * @param data Данные модели (вершины и уникальные рёбра).
+   * @param settings Настройки отображения.
+   * @param view Поворот сцены (см. sceneRotation()).
+   * @param model Матрица модели.
+   * @param axes Рисовать ли оси координат.
+   */
+  void render(const Model::Data &data, const RenderSettings &settings,
+              const TransformMatrix &view, const TransformMatrix &model,
+              bool axes = false);
+
+  /**
+   * @brief Поворот сцены так, как его задают glRotatef() в paintGL().
+   *
+   * @param x_angle Поворот вокруг оси X в градусах.
+   * @param y_angle Поворот вокруг оси Y в градусах.
+   * @param z_angle Поворот вокруг оси Z в градусах.
+   * @return Произведение Rx * Ry * Rz.
+   */
+  static TransformMatrix sceneRotation(double x_angle, double y_angle,
+                                       double z_angle) noexcept;
+
+  /**
+   * @brief Перевод цвета в формат пикселя 0xAARRGGBB.
+   */
+  static uint32_t toArgb(const RenderSettings::Color &color) noexcept;
+
+ private:
+  /**
+   * @brief Минимальная высота полосы при автоматическом выборе их числа.
+   */
+  static constexpr int kMinTileRows = 32;
+
+  /**
+   * @brief Минимальный размер блока вершин при параллельном проецировании.
+   */
+  static constexpr std::size_t kMinVertexBlock = 1 << 16;
+
+  /**
+   * @brief Точка в пространстве камеры.
+   */
+  struct EyePoint {
+    float x, y, z;  ///< Координаты (камера смотрит вдоль -Z).
+  };
+
+  /**
+   * @brief Проекция вершины на изображение.
+   */
+  struct ScreenPoint {
+    float x, y;    ///< Координаты в пикселях (ось Y направлена вниз).
+    bool visible;  ///< Лежит ли вершина между ближней и дальней плоскостями.
+  };
+
+  /**
+   * @brief Прямоугольник пикселей [x0, x1) x [y0, y1).
+   */
+  struct Tile {
+    int x0, y0, x1, y1;  ///< Границы.
+  };
+
+  /**
+   * @brief Параметры рисования линий.
+   */
+  struct LineStyle {
+    uint32_t color;    ///< Цвет.
+    int width;         ///< Толщина в пикселях.
+    uint16_t pattern;  ///< Шаблон пунктира, как в glLineStipple().
+  };
+
+  /**
+   * @brief Перевод вершин в пространство камеры и их проецирование.
+   */
+  void projectVertexes(const Model::Vertexes &vertexes,
+                       const TransformMatrix &eye_matrix);
+
+  /**
+   * @brief Отрисовка одной полосы изображения.
+   */
+  void renderTile(const Tile &tile, const Model::Data &data,
+                  const RenderSettings &settings,
+                  const TransformMatrix &axes_matrix, bool axes);
+
+  /**
+   * @brief Отрисовка ребра с отсечением по глубине.
+   */
+  void drawEdge(EyePoint a, EyePoint b, const LineStyle &style,
+                const Tile &tile) noexcept;
+
+  /**
+   * @brief Проекция точки камеры в координаты изображения.
+   *
+   * @param p Точка, лежащая между ближней и дальней плоскостями.
+   * @return Координаты в пикселях.
+   */
+  ScreenPoint project(const EyePoint &p) const noexcept;
+
+  /**
+   * @brief Ближняя плоскость текущей проекции.
+   */
+  float nearPlane() const noexcept;
+
+  /**
+   * @brief Отсечение отрезка ближней и дальней плоскостями.
+   *
+   * @return false, если отрезок целиком вне области видимости.
+   */
+  bool clipDepth(EyePoint &a, EyePoint &b) const noexcept;
+
+  /**
+   * @brief Отрисовка отрезка в пределах прямоугольника tile.
+   *
+   * Как в OpenGL без сглаживания, отрезок проходится с шагом в один пиксель
+   * по длинной оси, а толщина откладывается по короткой; счётчик пунктира
+   * отсчитывается от начала отрезка, поэтому результат не зависит от
+   * разбиения на полосы.
+   */
+  void drawLine(const ScreenPoint &a, const ScreenPoint &b,
+                const LineStyle &style, const Tile &tile) noexcept;
+
+  /**
+   * @brief Отрисовка точки в пределах прямоугольника tile.
+   */
+  void drawPoint(const ScreenPoint &p, float size,
+                 RenderSettings::PointShape shape, uint32_t color,
+                 const Tile &tile) noexcept;
+
+  /**
+   * @brief Закраска горизонтального отрезка строки y от x0 до x1.
+   */
+  void fillSpan(int y, int x0, int x1, uint32_t color,
+                const Tile &tile) noexcept;
+
+  int frame_width;                ///< Ширина изображения.
+  int frame_height;               ///< Высота изображения.
+  unsigned int tile_threads = 0;  ///< Количество полос.
+  std::vector<uint32_t> frame;    ///< Пиксели изображения.
+  RenderSettings::Projection projection =
+      RenderSettings::Projection::kParallel;  ///< Текущая проекция.
+  std::vector<EyePoint> eye;        ///< Вершины в пространстве камеры.
+  std::vector<ScreenPoint> screen;  ///< Проекции вершин.
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_RASTERIZER_H_
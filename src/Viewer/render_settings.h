@@ -0,0 +1,134 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением структуры RenderSettings — разобранных
+настроек отображения модели.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_RENDER_SETTINGS_H_
+#define CPP4_3DVIEWER_V2_VIEWER_RENDER_SETTINGS_H_
+
+#include <string>
+
+namespace s21 {
+
+/**
+ * @brief Настройки отображения модели в типизированном виде.
+ *
+ * Строковые значения настроек интерфейса разбираются один раз при их
+ * изменении, а отрисовка каждого кадра читает только поля этой структуры,
+ * без обращения к QSettings и сравнения строк.
+ */
+struct RenderSettings {
+  /**
+   * @brief Тип проекции.
+   */
+  enum class Projection {
+    kParallel,  ///< Параллельная (ортографическая) проекция.
+    kCentral,   ///< Центральная (перспективная) проекция.
+  };
+
+  /**
+   * @brief Тип линии рёбер.
+   */
+  enum class LineType {
+    kSolid,   ///< Сплошная линия.
+    kDashed,  ///< Пунктирная линия.
+  };
+
+  /**
+   * @brief Способ отображения вершин.
+   */
+  enum class PointShape {
+    kNone,    ///< Вершины не отображаются.
+    kCircle,  ///< Круглые (сглаженные) точки.
+    kSquare,  ///< Квадратные точки.
+  };
+
+  /**
+   * @brief Цвет в формате RGBA с компонентами от 0 до 1.
+   */
+  struct Color {
+    float r, g, b, a;  ///< Компоненты цвета.
+
+    /**
+     * @brief Указатель на компоненты для glColor4fv().
+     */
+    inline const float *data() const noexcept { return &r; }
+  };
+
+  Projection projection = Projection::kParallel;  ///< Тип проекции.
+  LineType line_type = LineType::kSolid;          ///< Тип линии.
+  Color line_color{1, 1, 1, 1};                   ///< Цвет линий.
+  float line_width = 1;                           ///< Толщина линий.
+  PointShape vertex_display = PointShape::kNone;  ///< Вид вершин.
+  Color vertex_color{1, 1, 1, 1};                 ///< Цвет вершин.
+  float vertex_size = 1;                          ///< Размер вершин.
+  Color background_color{0, 0, 0, 1};             ///< Цвет фона.
+
+  /**
+   * @brief Разбор названия цвета из настроек интерфейса.
+   *
+   * @param name Название цвета ("Red", "Green", ...).
+   * @param fallback Цвет для пустого или неизвестного названия.
+   */
+  static inline Color parseColor(const std::string &name,
+                                 Color fallback) noexcept {
+    if (name == "Red") return {1, 0, 0, 1};
+    if (name == "Green") return {0, 1, 0, 1};
+    if (name == "Blue") return {0, 0, 1, 1};
+    if (name == "Yellow") return {1, 1, 0, 1};
+    if (name == "Pink") return {1, 0, 1, 1};
+    if (name == "White") return {1, 1, 1, 1};
+    if (name == "Black") return {0, 0, 0, 1};
+    return fallback;
+  }
+
+  /**
+   * @brief Установка одной настройки по её ключу в файле настроек.
+   *
+   * Неизвестные ключи игнорируются, некорректные значения заменяются
+   * значениями по умолчанию.
+   *
+   * @param key Ключ настройки ("projection", "lineType", ...).
+   * @param value Строковое значение настройки.
+   */
+  inline void set(const std::string &key, const std::string &value) {
+    if (key == "projection") {
+      projection = value == "Central" ? Projection::kCentral
+                                      : Projection::kParallel;
+    } else if (key == "lineType") {
+      line_type = value == "Dashed" ? LineType::kDashed : LineType::kSolid;
+    } else if (key == "lineColor") {
+      line_color = parseColor(value, {1, 1, 1, 1});
+    } else if (key == "lineWidth") {
+      line_width = parseSize(value);
+    } else if (key == "vertexDisplay") {
+      vertex_display = value == "Square"   ? PointShape::kSquare
+                       : value == "Circle" ? PointShape::kCircle
+                                           : PointShape::kNone;
+    } else if (key == "vertexColor") {
+      vertex_color = parseColor(value, {1, 1, 1, 1});
+    } else if (key == "vertexSize") {
+      vertex_size = parseSize(value);
+    } else if (key == "backgroundColor") {
+      background_color = parseColor(value, {0, 0, 0, 1});
+    }
+  }
+
+ private:
+  /**
+   * @brief Разбор толщины линии или размера точки (не меньше 1).
+   */
+  static inline float parseSize(const std::string &value) noexcept {
+    float size = 0;
+    for (char c : value) {
+      if (c < '0' || c > '9') break;
+      size = size * 10 + (c - '0');
+    }
+    return size < 1 ? 1 : size;
+  }
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_RENDER_SETTINGS_H_
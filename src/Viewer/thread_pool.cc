@@ -0,0 +1,91 @@
+#include "thread_pool.h"
+
+/**
+ * @brief Получение единственного экземпляра пула.
+ *
+ * Пул создаётся при первом обращении.
+ *
+ * @return Ссылка на пул потоков.
+ */
+s21::ThreadPool &s21::ThreadPool::getInstance() {
+  static ThreadPool instance;
+  return instance;
+}
+
+/**
+ * @brief Конструктор пула.
+ *
+ * Запускает по одному рабочему потоку на каждое ядро, кроме одного,
+ * которое остаётся за вызывающим потоком.
+ */
+s21::ThreadPool::ThreadPool() {
+  unsigned int cores = std::thread::hardware_concurrency();
+  for (unsigned int i = 1; i < cores; i++)
+    workers.emplace_back(&ThreadPool::work, this);
+}
+
+/**
+ * @brief Деструктор пула.
+ *
+ * Дожидается выполнения уже поставленных задач и завершает рабочие потоки.
+ */
+s21::ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  available.notify_all();
+  for (std::thread &worker : workers) worker.join();
+}
+
+/**
+ * @brief Постановка задачи в очередь пула.
+ *
+ * Если в пуле нет рабочих потоков (одноядерная система), задача выполняется
+ * сразу в вызывающем потоке.
+ *
+ * @param task Задача.
+ * @return Future, который становится готовым после выполнения задачи.
+ */
+std::future<void> s21::ThreadPool::submit(std::function<void()> task) {
+  auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+  std::future<void> result = packaged->get_future();
+  if (workers.empty())
+    (*packaged)();
+  else
+    enqueue([packaged]() { (*packaged)(); });
+  return result;
+}
+
+/**
+ * @brief Добавление задачи в очередь без ожидания результата.
+ *
+ * @param task Задача.
+ */
+void s21::ThreadPool::enqueue(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(std::move(task));
+  }
+  available.notify_one();
+}
+
+/**
+ * @brief Цикл рабочего потока.
+ *
+ * Поток забирает задачи из очереди, пока пул не начнёт завершение и очередь
+ * не опустеет.
+ */
+void s21::ThreadPool::work() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      available.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (tasks.empty()) return;
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    task();
+  }
+}
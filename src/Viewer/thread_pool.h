@@ -0,0 +1,125 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением класса ThreadPool — общего пула
+рабочих потоков приложения.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_THREAD_POOL_H_
+#define CPP4_3DVIEWER_V2_VIEWER_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace s21 {
+
+/**
+ * @brief Пул рабочих потоков.
+ *
+ * Пул создаётся один раз на приложение (шаблон Singleton) и содержит по
+ * одному потоку на ядро, кроме вызывающего. Используется для параллельного
+ * разбора файлов, преобразований вершин и кодирования кадров.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Получение единственного экземпляра пула.
+   *
+   * @return Ссылка на пул потоков.
+   */
+  static ThreadPool &getInstance();
+
+  /**
+   * @brief Количество потоков, участвующих в parallelFor (вместе с
+   * вызывающим).
+   */
+  inline unsigned int concurrency() const noexcept {
+    return static_cast<unsigned int>(workers.size()) + 1;
+  }
+
+  /**
+   * @brief Постановка задачи в очередь пула.
+   *
+   * @param task Задача.
+   * @return Future, который становится готовым после выполнения задачи.
+   */
+  std::future<void> submit(std::function<void()> task);
+
+  /**
+   * @brief Параллельное выполнение task(i) для всех i из [0, count).
+   *
+   * Вызывающий поток сам разбирает индексы наравне с потоками пула и
+   * возвращается, когда выполнены все итерации, поэтому метод можно вызывать
+   * и из задач пула без риска взаимной блокировки.
+   *
+   * @param count Количество итераций.
+   * @param task Тело итерации, принимающее индекс.
+   */
+  template <typename F>
+  void parallelFor(std::size_t count, F &&task) {
+    if (count == 0) return;
+    if (count == 1 || workers.empty()) {
+      for (std::size_t i = 0; i < count; i++) task(i);
+      return;
+    }
+
+    struct Batch {
+      std::atomic<std::size_t> next{0};
+      std::atomic<std::size_t> done{0};
+      std::mutex mutex;
+      std::condition_variable finished;
+    };
+    auto batch = std::make_shared<Batch>();
+    auto body = [batch, count, &task]() {
+      std::size_t i;
+      while ((i = batch->next.fetch_add(1)) < count) {
+        task(i);
+        if (batch->done.fetch_add(1) + 1 == count) {
+          std::lock_guard<std::mutex> lock(batch->mutex);
+          batch->finished.notify_all();
+        }
+      }
+    };
+
+    std::size_t helpers = std::min<std::size_t>(count - 1, workers.size());
+    for (std::size_t h = 0; h < helpers; h++) enqueue(body);
+    body();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&] { return batch->done.load() == count; });
+  }
+
+ private:
+  ThreadPool();
+  ThreadPool(const ThreadPool &other) = delete;
+  void operator=(const ThreadPool &other) = delete;
+  ~ThreadPool();
+
+  /**
+   * @brief Добавление задачи в очередь без ожидания результата.
+   */
+  void enqueue(std::function<void()> task);
+
+  /**
+   * @brief Цикл рабочего потока.
+   */
+  void work();
+
+  std::vector<std::thread> workers;         ///< Рабочие потоки.
+  std::deque<std::function<void()>> tasks;  ///< Очередь задач.
+  std::mutex mutex;                   ///< Защита очереди задач.
+  std::condition_variable available;  ///< Сигнал о новой задаче.
+  bool stopping = false;  ///< Признак завершения работы пула.
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_THREAD_POOL_H_
@@ -0,0 +1,269 @@
+#include "transform_kernels.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define S21_KERNELS_X86 1
+#endif
+
+namespace {
+
+/**
+ * @brief Коэффициенты матрицы преобразования в одинарной точности.
+ */
+struct Coefficients {
+  float m[3][4];
+
+  explicit Coefficients(const s21::TransformMatrix &matrix) noexcept {
+    for (int r = 0; r < 3; r++)
+      for (int c = 0; c < 4; c++) m[r][c] = static_cast<float>(matrix.m[r][c]);
+  }
+};
+
+/**
+ * @brief Скалярное применение матрицы к упакованным вершинам.
+ */
+void transformScalar(float *p, std::size_t count,
+                     const Coefficients &c) noexcept {
+  for (std::size_t i = 0; i < count; i++, p += 3) {
+    float x = p[0], y = p[1], z = p[2];
+    p[0] = c.m[0][0] * x + c.m[0][1] * y + c.m[0][2] * z + c.m[0][3];
+    p[1] = c.m[1][0] * x + c.m[1][1] * y + c.m[1][2] * z + c.m[1][3];
+    p[2] = c.m[2][0] * x + c.m[2][1] * y + c.m[2][2] * z + c.m[2][3];
+  }
+}
+
+#ifdef S21_KERNELS_X86
+
+/*
+ * Транспонирование 4 упакованных вершин.
+ *
+ * Регистры a0 = x0 y0 z0 x1, a1 = y1 z1 x2 y2, a2 = z2 x3 y3 z3 превращаются в
+ * x = x0 x1 x2 x3, y = y0 y1 y2 y3, z = z0 z1 z2 z3 и обратно. Все
+ * перестановки делаются внутри 128-битных половин, поэтому та же
+ * последовательность работает для AVX2 и AVX-512, если в каждой 128-битной
+ * половине лежит своя группа из 4 вершин.
+ */
+#define S21_DEINTERLEAVE(SHUFFLE, a0, a1, a2, x, y, z)                       \
+  do {                                                                       \
+    x = SHUFFLE(SHUFFLE(a0, a0, _MM_SHUFFLE(3, 3, 0, 0)),                    \
+                SHUFFLE(a1, a2, _MM_SHUFFLE(1, 1, 2, 2)),                    \
+                _MM_SHUFFLE(2, 0, 2, 0));                                    \
+    y = SHUFFLE(SHUFFLE(a0, a1, _MM_SHUFFLE(0, 0, 1, 1)),                    \
+                SHUFFLE(a1, a2, _MM_SHUFFLE(2, 2, 3, 3)),                    \
+                _MM_SHUFFLE(2, 0, 2, 0));                                    \
+    z = SHUFFLE(SHUFFLE(a0, a1, _MM_SHUFFLE(1, 1, 2, 2)),                    \
+                SHUFFLE(a2, a2, _MM_SHUFFLE(3, 3, 0, 0)),                    \
+                _MM_SHUFFLE(2, 0, 2, 0));                                    \
+  } while (0)
+
+#define S21_INTERLEAVE(SHUFFLE, x, y, z, b0, b1, b2)                         \
+  do {                                                                       \
+    b0 = SHUFFLE(SHUFFLE(x, y, _MM_SHUFFLE(0, 0, 0, 0)),                     \
+                 SHUFFLE(z, x, _MM_SHUFFLE(1, 1, 0, 0)),                     \
+                 _MM_SHUFFLE(2, 0, 2, 0));                                   \
+    b1 = SHUFFLE(SHUFFLE(y, z, _MM_SHUFFLE(1, 1, 1, 1)),                     \
+                 SHUFFLE(x, y, _MM_SHUFFLE(2, 2, 2, 2)),                     \
+                 _MM_SHUFFLE(2, 0, 2, 0));                                   \
+    b2 = SHUFFLE(SHUFFLE(z, x, _MM_SHUFFLE(3, 3, 2, 2)),                     \
+                 SHUFFLE(y, z, _MM_SHUFFLE(3, 3, 3, 3)),                     \
+                 _MM_SHUFFLE(2, 0, 2, 0));                                   \
+  } while (0)
+
+void transformSse2(float *p, std::size_t count,
+                   const Coefficients &c) noexcept {
+  __m128 m[3][4];
+  for (int r = 0; r < 3; r++)
+    for (int k = 0; k < 4; k++) m[r][k] = _mm_set1_ps(c.m[r][k]);
+
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4, p += 12) {
+    __m128 a0 = _mm_loadu_ps(p), a1 = _mm_loadu_ps(p + 4),
+           a2 = _mm_loadu_ps(p + 8), x, y, z, o[3];
+    S21_DEINTERLEAVE(_mm_shuffle_ps, a0, a1, a2, x, y, z);
+    for (int r = 0; r < 3; r++)
+      o[r] = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(m[r][0], x), _mm_mul_ps(m[r][1], y)),
+          _mm_add_ps(_mm_mul_ps(m[r][2], z), m[r][3]));
+    S21_INTERLEAVE(_mm_shuffle_ps, o[0], o[1], o[2], a0, a1, a2);
+    _mm_storeu_ps(p, a0);
+    _mm_storeu_ps(p + 4, a1);
+    _mm_storeu_ps(p + 8, a2);
+  }
+  transformScalar(p, count - i, c);
+}
+
+/*
+ * В AVX2-версии младшая 128-битная половина регистров обрабатывает вершины
+ * 0-3 группы, старшая — вершины 4-7.
+ */
+__attribute__((target("avx2,fma"))) inline __m256 loadHalves(const float *p) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)),
+                              _mm_loadu_ps(p + 12), 1);
+}
+
+__attribute__((target("avx2,fma"))) inline void storeHalves(float *p,
+                                                            __m256 v) {
+  _mm_storeu_ps(p, _mm256_castps256_ps128(v));
+  _mm_storeu_ps(p + 12, _mm256_extractf128_ps(v, 1));
+}
+
+__attribute__((target("avx2,fma"))) void transformAvx2(
+    float *p, std::size_t count, const Coefficients &c) noexcept {
+  __m256 m[3][4];
+  for (int r = 0; r < 3; r++)
+    for (int k = 0; k < 4; k++) m[r][k] = _mm256_set1_ps(c.m[r][k]);
+
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8, p += 24) {
+    __m256 a0 = loadHalves(p), a1 = loadHalves(p + 4), a2 = loadHalves(p + 8),
+           x, y, z, o[3];
+    S21_DEINTERLEAVE(_mm256_shuffle_ps, a0, a1, a2, x, y, z);
+    for (int r = 0; r < 3; r++)
+      o[r] = _mm256_fmadd_ps(
+          m[r][0], x,
+          _mm256_fmadd_ps(m[r][1], y, _mm256_fmadd_ps(m[r][2], z, m[r][3])));
+    S21_INTERLEAVE(_mm256_shuffle_ps, o[0], o[1], o[2], a0, a1, a2);
+    storeHalves(p, a0);
+    storeHalves(p + 4, a1);
+    storeHalves(p + 8, a2);
+  }
+  transformSse2(p, count - i, c);
+}
+
+/*
+ * В AVX-512-версии каждая из четырёх 128-битных четвертей регистров
+ * обрабатывает свою группу из 4 вершин (всего 16 вершин за итерацию).
+ */
+__attribute__((target("avx512f"))) inline __m512 loadQuarters(const float *p) {
+  __m512 v = _mm512_castps128_ps512(_mm_loadu_ps(p));
+  v = _mm512_insertf32x4(v, _mm_loadu_ps(p + 12), 1);
+  v = _mm512_insertf32x4(v, _mm_loadu_ps(p + 24), 2);
+  return _mm512_insertf32x4(v, _mm_loadu_ps(p + 36), 3);
+}
+
+__attribute__((target("avx512f"))) inline void storeQuarters(float *p,
+                                                             __m512 v) {
+  // Маскированная форма извлечения не опирается на _mm_undefined_ps, на
+  // котором GCC выдаёт ложное предупреждение -Wmaybe-uninitialized.
+  const __m128 zero = _mm_setzero_ps();
+  _mm_storeu_ps(p, _mm512_mask_extractf32x4_ps(zero, 0xF, v, 0));
+  _mm_storeu_ps(p + 12, _mm512_mask_extractf32x4_ps(zero, 0xF, v, 1));
+  _mm_storeu_ps(p + 24, _mm512_mask_extractf32x4_ps(zero, 0xF, v, 2));
+  _mm_storeu_ps(p + 36, _mm512_mask_extractf32x4_ps(zero, 0xF, v, 3));
+}
+
+__attribute__((target("avx512f"))) void transformAvx512(
+    float *p, std::size_t count, const Coefficients &c) noexcept {
+  __m512 m[3][4];
+  for (int r = 0; r < 3; r++)
+    for (int k = 0; k < 4; k++) m[r][k] = _mm512_set1_ps(c.m[r][k]);
+
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16, p += 48) {
+    __m512 a0 = loadQuarters(p), a1 = loadQuarters(p + 4),
+           a2 = loadQuarters(p + 8), x, y, z, o[3];
+    S21_DEINTERLEAVE(_mm512_shuffle_ps, a0, a1, a2, x, y, z);
+    for (int r = 0; r < 3; r++)
+      o[r] = _mm512_fmadd_ps(
+          m[r][0], x,
+          _mm512_fmadd_ps(m[r][1], y, _mm512_fmadd_ps(m[r][2], z, m[r][3])));
+    S21_INTERLEAVE(_mm512_shuffle_ps, o[0], o[1], o[2], a0, a1, a2);
+    storeQuarters(p, a0);
+    storeQuarters(p + 4, a1);
+    storeQuarters(p + 8, a2);
+  }
+  transformSse2(p, count - i, c);
+}
+
+#undef S21_DEINTERLEAVE
+#undef S21_INTERLEAVE
+
+#endif  // S21_KERNELS_X86
+
+/**
+ * @brief Определение самого широкого поддерживаемого набора инструкций.
+ */
+s21::kernels::Isa detectIsa() noexcept {
+#ifdef S21_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return s21::kernels::Isa::kAvx512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return s21::kernels::Isa::kAvx2;
+  return s21::kernels::Isa::kSse2;
+#else
+  return s21::kernels::Isa::kScalar;
+#endif
+}
+
+std::atomic<s21::kernels::Isa> &currentIsa() noexcept {
+  static std::atomic<s21::kernels::Isa> isa{s21::kernels::bestIsa()};
+  return isa;
+}
+
+}  // namespace
+
+/**
+ * @brief Самый широкий набор инструкций, поддерживаемый процессором.
+ *
+ * Проверка выполняется один раз при первом вызове.
+ */
+s21::kernels::Isa s21::kernels::bestIsa() noexcept {
+  static const Isa best = detectIsa();
+  return best;
+}
+
+/**
+ * @brief Набор инструкций, которым сейчас выполняются ядра.
+ */
+s21::kernels::Isa s21::kernels::activeIsa() noexcept {
+  return currentIsa().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Принудительный выбор набора инструкций.
+ *
+ * @param isa Желаемый набор инструкций; неподдерживаемый набор заменяется на
+ * bestIsa().
+ */
+void s21::kernels::setIsa(Isa isa) noexcept {
+  currentIsa().store(isa > bestIsa() ? bestIsa() : isa,
+                     std::memory_order_relaxed);
+}
+
+/**
+ * @brief Название набора инструкций.
+ */
+const char *s21::kernels::isaName(Isa isa) noexcept {
+  switch (isa) {
+    case Isa::kSse2:
+      return "SSE2";
+    case Isa::kAvx2:
+      return "AVX2";
+    case Isa::kAvx512:
+      return "AVX-512";
+    default:
+      return "scalar";
+  }
+}
+
+/**
+ * @brief Применение матрицы аффинного преобразования к вершинам.
+ */
+void s21::kernels::transform(float *xyz, std::size_t count,
+                             const TransformMatrix &matrix) noexcept {
+  Coefficients c(matrix);
+  switch (activeIsa()) {
+#ifdef S21_KERNELS_X86
+    case Isa::kAvx512:
+      return transformAvx512(xyz, count, c);
+    case Isa::kAvx2:
+      return transformAvx2(xyz, count, c);
+    case Isa::kSse2:
+      return transformSse2(xyz, count, c);
+#endif
+    default:
+      return transformScalar(xyz, count, c);
+  }
+}
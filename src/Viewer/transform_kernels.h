@@ -0,0 +1,78 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением векторизованных ядер преобразования
+вершин и выбором набора инструкций процессора во время выполнения.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_TRANSFORM_KERNELS_H_
+#define CPP4_3DVIEWER_V2_VIEWER_TRANSFORM_KERNELS_H_
+
+#include <cstddef>
+
+#include "transform_matrix.h"
+
+namespace s21 {
+
+/**
+ * @brief Ядра преобразования упакованных вершин (x0 y0 z0 x1 y1 z1 ...).
+ *
+ * Каждое ядро реализовано для SSE2, AVX2+FMA и AVX-512F, а также в скалярном
+ * виде. Набор инструкций выбирается один раз по возможностям процессора;
+ * на платформах, отличных от x86-64, всегда используется скалярная версия.
+ */
+namespace kernels {
+
+/**
+ * @brief Набор инструкций, которым выполняются ядра.
+ */
+enum class Isa {
+  kScalar,  ///< Скалярный код без явной векторизации.
+  kSse2,    ///< 4 числа float за инструкцию.
+  kAvx2,    ///< 8 чисел float за инструкцию, FMA.
+  kAvx512,  ///< 16 чисел float за инструкцию, FMA.
+};
+
+/**
+ * @brief Самый широкий набор инструкций, поддерживаемый процессором.
+ */
+Isa bestIsa() noexcept;
+
+/**
+ * @brief Набор инструкций, которым сейчас выполняются ядра.
+ */
+Isa activeIsa() noexcept;
+
+/**
+ * @brief Принудительный выбор набора инструкций.
+ *
+ * Используется для тестов и замеров. Набор, не поддерживаемый процессором,
+ * заменяется на bestIsa().
+ *
+ * @param isa Желаемый набор инструкций.
+ */
+void setIsa(Isa isa) noexcept;
+
+/**
+ * @brief Название набора инструкций.
+ */
+const char *isaName(Isa isa) noexcept;
+
+/**
+ * @brief Применение матрицы аффинного преобразования к вершинам.
+ *
+ * Сдвиг, поворот и масштабирование выражаются одной матрицей (см.
+ * TransformMatrix), поэтому отдельных ядер для них нет. Вершины группами
+ * по 4 транспонируются из упакованного вида в отдельные регистры x, y, z,
+ * умножаются на матрицу и упаковываются обратно.
+ *
+ * @param xyz Упакованные координаты вершин.
+ * @param count Количество вершин.
+ * @param matrix Матрица преобразования.
+ */
+void transform(float *xyz, std::size_t count,
+               const TransformMatrix &matrix) noexcept;
+
+}  // namespace kernels
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_TRANSFORM_KERNELS_H_
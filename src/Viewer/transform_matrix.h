@@ -0,0 +1,127 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением структуры TransformMatrix — матрицы
+аффинного преобразования 3x4.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_TRANSFORM_MATRIX_H_
+#define CPP4_3DVIEWER_V2_VIEWER_TRANSFORM_MATRIX_H_
+
+#include <cmath>
+
+namespace s21 {
+
+/**
+ * @brief Матрица аффинного преобразования.
+ *
+ * Хранит верхние три строки однородной матрицы 4x4 (нижняя строка всегда
+ * 0 0 0 1): левый блок 3x3 — линейная часть, последний столбец — сдвиг.
+ * Произведение A * B означает «сначала B, затем A», поэтому цепочку
+ * преобразований можно свернуть в одну матрицу и применить к вершинам за
+ * один проход.
+ */
+struct TransformMatrix {
+  double m[3][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}};  ///< Элементы.
+
+  /**
+   * @brief Единичная матрица.
+   */
+  static inline TransformMatrix identity() noexcept { return {}; }
+
+  /**
+   * @brief Матрица сдвига на (x, y, z).
+   */
+  static inline TransformMatrix translation(double x, double y,
+                                            double z) noexcept {
+    TransformMatrix t;
+    t.m[0][3] = x;
+    t.m[1][3] = y;
+    t.m[2][3] = z;
+    return t;
+  }
+
+  /**
+   * @brief Матрица поворота вокруг оси X на угол a (в радианах).
+   */
+  static inline TransformMatrix rotationX(double a) noexcept {
+    TransformMatrix t;
+    double c = cos(a), s = sin(a);
+    t.m[1][1] = c, t.m[1][2] = -s;
+    t.m[2][1] = s, t.m[2][2] = c;
+    return t;
+  }
+
+  /**
+   * @brief Матрица поворота вокруг оси Y на угол a (в радианах).
+   */
+  static inline TransformMatrix rotationY(double a) noexcept {
+    TransformMatrix t;
+    double c = cos(a), s = sin(a);
+    t.m[0][0] = c, t.m[0][2] = s;
+    t.m[2][0] = -s, t.m[2][2] = c;
+    return t;
+  }
+
+  /**
+   * @brief Матрица поворота вокруг оси Z на угол a (в радианах).
+   */
+  static inline TransformMatrix rotationZ(double a) noexcept {
+    TransformMatrix t;
+    double c = cos(a), s = sin(a);
+    t.m[0][0] = c, t.m[0][1] = -s;
+    t.m[1][0] = s, t.m[1][1] = c;
+    return t;
+  }
+
+  /**
+   * @brief Матрица равномерного масштабирования с коэффициентом a.
+   */
+  static inline TransformMatrix scaling(double a) noexcept {
+    TransformMatrix t;
+    t.m[0][0] = t.m[1][1] = t.m[2][2] = a;
+    return t;
+  }
+
+  /**
+   * @brief Композиция преобразований: сначала other, затем this.
+   */
+  inline TransformMatrix operator*(
+      const TransformMatrix &other) const noexcept {
+    TransformMatrix t;
+    for (int r = 0; r < 3; r++) {
+      for (int c = 0; c < 4; c++) {
+        t.m[r][c] = m[r][0] * other.m[0][c] + m[r][1] * other.m[1][c] +
+                    m[r][2] * other.m[2][c];
+      }
+      t.m[r][3] += m[r][3];
+    }
+    return t;
+  }
+
+  /**
+   * @brief Запись матрицы в виде 4x4 по столбцам, как её принимает OpenGL
+   * (glMultMatrixf, glLoadMatrixd).
+   */
+  template <typename T>
+  inline void toColumnMajor(T out[16]) const noexcept {
+    for (int c = 0; c < 4; c++) {
+      for (int r = 0; r < 3; r++) out[c * 4 + r] = static_cast<T>(m[r][c]);
+      out[c * 4 + 3] = c == 3 ? 1 : 0;
+    }
+  }
+
+  /**
+   * @brief Применение преобразования к точке (x, y, z) на месте.
+   */
+  template <typename T>
+  inline void apply(T &x, T &y, T &z) const noexcept {
+    double px = x, py = y, pz = z;
+    x = static_cast<T>(m[0][0] * px + m[0][1] * py + m[0][2] * pz + m[0][3]);
+    y = static_cast<T>(m[1][0] * px + m[1][1] * py + m[1][2] * pz + m[1][3]);
+    z = static_cast<T>(m[2][0] * px + m[2][1] * py + m[2][2] * pz + m[2][3]);
+  }
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_TRANSFORM_MATRIX_H_
@@ -0,0 +1,176 @@
+/*!
+\file
+\brief Заголовочный файл с объявлением шаблона VertexBuffer — непрерывного
+хранилища координат вершин модели.
+*/
+
+#ifndef CPP4_3DVIEWER_V2_VIEWER_VERTEX_BUFFER_H_
+#define CPP4_3DVIEWER_V2_VIEWER_VERTEX_BUFFER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace s21 {
+
+/**
+ * @brief Способ размещения координат вершин в памяти.
+ */
+enum class VertexLayout {
+  kPacked,  ///< Упакованные тройки x0 y0 z0 x1 y1 z1 ... в одном массиве.
+  kSoA,     ///< Структура массивов: отдельные массивы x, y и z.
+};
+
+/**
+ * @brief Непрерывное хранилище координат вершин.
+ *
+ * Все вершины лежат в одном (kPacked) или трёх (kSoA) непрерывных массивах без
+ * отдельной аллокации на вершину. Упакованный вариант с типом float можно
+ * передавать в OpenGL без перепаковки, вариант kSoA удобен для
+ * векторизованных преобразований по одной координате.
+ *
+ * @tparam T Тип координаты (float или double).
+ * @tparam L Способ размещения координат в памяти.
+ */
+template <typename T, VertexLayout L = VertexLayout::kPacked>
+class VertexBuffer {
+ public:
+  using value_type = T;  ///< Тип координаты.
+  static constexpr VertexLayout layout = L;  ///< Размещение координат.
+
+  /**
+   * @brief Количество вершин.
+   */
+  inline std::size_t size() const noexcept {
+    return L == VertexLayout::kPacked ? coords_[0].size() / 3
+                                      : coords_[0].size();
+  }
+
+  /**
+   * @brief Проверяет, пусто ли хранилище.
+   */
+  inline bool empty() const noexcept { return coords_[0].empty(); }
+
+  /**
+   * @brief Резервирует память под count вершин.
+   */
+  inline void reserve(std::size_t count) {
+    if (L == VertexLayout::kPacked) {
+      coords_[0].reserve(count * 3);
+    } else {
+      for (std::vector<T> &c : coords_) c.reserve(count);
+    }
+  }
+
+  /**
+   * @brief Изменяет количество вершин; новые вершины заполняются нулями.
+   */
+  inline void resize(std::size_t count) {
+    if (L == VertexLayout::kPacked) {
+      coords_[0].resize(count * 3);
+    } else {
+      for (std::vector<T> &c : coords_) c.resize(count);
+    }
+  }
+
+  /**
+   * @brief Удаляет все вершины с освобождением памяти.
+   */
+  inline void clear() {
+    for (std::vector<T> &c : coords_) std::vector<T>().swap(c);
+  }
+
+  /**
+   * @brief Добавляет вершину в конец хранилища.
+   */
+  inline void push_back(T x, T y, T z) {
+    if (L == VertexLayout::kPacked) {
+      coords_[0].insert(coords_[0].end(), {x, y, z});
+    } else {
+      coords_[0].push_back(x);
+      coords_[1].push_back(y);
+      coords_[2].push_back(z);
+    }
+  }
+
+  /**
+   * @brief Копирует все вершины src, начиная с вершины first.
+   *
+   * Хранилище должно уже содержать не меньше first + src.size() вершин.
+   */
+  inline void copy(const VertexBuffer &src, std::size_t first) noexcept {
+    for (std::size_t c = 0; c < (L == VertexLayout::kPacked ? 1 : 3); c++)
+      std::copy(src.coords_[c].begin(), src.coords_[c].end(),
+                coords_[c].begin() + first * stride());
+  }
+
+  /**
+   * @brief Заменяет содержимое count вершинами из упакованных троек packed.
+   *
+   * Для упакованного размещения выполняется одним копированием.
+   */
+  inline void assign(const T *packed, std::size_t count) {
+    if (L == VertexLayout::kPacked) {
+      coords_[0].assign(packed, packed + count * 3);
+    } else {
+      resize(count);
+      for (std::size_t i = 0; i < count; i++)
+        for (std::size_t c = 0; c < 3; c++) coords_[c][i] = packed[i * 3 + c];
+    }
+  }
+
+  /**
+   * @brief Координата c (0 — x, 1 — y, 2 — z) вершины i.
+   */
+  inline T &at(std::size_t i, std::size_t c) noexcept {
+    return L == VertexLayout::kPacked ? coords_[0][i * 3 + c] : coords_[c][i];
+  }
+
+  /**
+   * @brief Координата c (0 — x, 1 — y, 2 — z) вершины i.
+   */
+  inline const T &at(std::size_t i, std::size_t c) const noexcept {
+    return L == VertexLayout::kPacked ? coords_[0][i * 3 + c] : coords_[c][i];
+  }
+
+  inline T &x(std::size_t i) noexcept { return at(i, 0); }  ///< Координата x.
+  inline T &y(std::size_t i) noexcept { return at(i, 1); }  ///< Координата y.
+  inline T &z(std::size_t i) noexcept { return at(i, 2); }  ///< Координата z.
+  inline const T &x(std::size_t i) const noexcept { return at(i, 0); }
+  inline const T &y(std::size_t i) const noexcept { return at(i, 1); }
+  inline const T &z(std::size_t i) const noexcept { return at(i, 2); }
+
+  /**
+   * @brief Начало массива координаты c.
+   *
+   * Для kPacked все координаты лежат в одном массиве, и метод возвращает
+   * указатель на координату c первой вершины; шаг между вершинами — stride().
+   */
+  inline T *data(std::size_t c = 0) noexcept {
+    return L == VertexLayout::kPacked ? coords_[0].data() + c
+                                      : coords_[c].data();
+  }
+
+  /**
+   * @brief Начало массива координаты c.
+   */
+  inline const T *data(std::size_t c = 0) const noexcept {
+    return L == VertexLayout::kPacked ? coords_[0].data() + c
+                                      : coords_[c].data();
+  }
+
+  /**
+   * @brief Шаг (в элементах T) между одноимёнными координатами соседних
+   * вершин.
+   */
+  static constexpr std::size_t stride() noexcept {
+    return L == VertexLayout::kPacked ? 3 : 1;
+  }
+
+ private:
+  std::vector<T> coords_[3];  ///< Массивы координат (для kPacked — только [0]).
+};
+
+}  // namespace s21
+
+#endif  // CPP4_3DVIEWER_V2_VIEWER_VERTEX_BUFFER_H_
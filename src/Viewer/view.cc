@@ -1,9 +1,47 @@
 #include "view.h"
 
 #include <QtWidgets>
+#include <algorithm>
+#include <chrono>
 
+#include "mesh_cache.h"
+#include "thread_pool.h"
 #include "ui_view.h"
 
+/**
+ * @brief Файл настроек интерфейса.
+ */
+static const char kSettingsFile[] = "launch_settings.init";
+
+/**
+ * @brief Интервал между кадрами GIF-анимации в миллисекундах.
+ */
+static constexpr int kFrameInterval = 50;
+
+/**
+ * @brief Интервал проверки фоновой загрузки модели в миллисекундах.
+ */
+static constexpr int kLoadingInterval = 100;
+
+/**
+ * @brief Количество кадров GIF-анимации.
+ */
+static constexpr int kFrameCount = 50;
+
+/**
+ * @brief Соответствие ключей карты настроек от View и ключей файла настроек.
+ */
+static const char *const kSettingsKeys[][2] = {
+    {"projection", "projection"},
+    {"line_type", "lineType"},
+    {"line_color", "lineColor"},
+    {"line_width", "lineWidth"},
+    {"vertex_color", "vertexColor"},
+    {"vertex_size", "vertexSize"},
+    {"vertex_display", "vertexDisplay"},
+    {"background_color", "backgroundColor"},
+};
+
 /**
  * @brief Конструктор класса View.
  *
@@ -17,7 +55,7 @@ s21::View::View(QWidget *parent) : QMainWindow(parent), ui(new Ui::View) {
   ui->setupUi(this);
 
   // Создание объекта настроек
-  set = new QSettings("launch_settings.init", QSettings::IniFormat);
+  set = new QSettings(kSettingsFile, QSettings::IniFormat);
 
   // Установка соединений для передачи данных и событий
   connect(ui->widget, &Paint::send_info, this, &View::receiveInfo);
@@ -26,6 +64,18 @@ s21::View::View(QWidget *parent) : QMainWindow(parent), ui(new Ui::View) {
   connect(this, &View::signal_settings, ui->widget,
           &Paint::on_applySettingsButton_clicked);
 
+  // Индикатор и отмена фоновой загрузки модели в строке состояния
+  load_progress = new QProgressBar(this);
+  load_cancel = new QPushButton("Отмена", this);
+  statusBar()->addPermanentWidget(load_progress);
+  statusBar()->addPermanentWidget(load_cancel);
+  loadingFinished();
+  connect(ui->widget, &Paint::send_progress, this, &View::receiveProgress);
+  connect(ui->widget, &Paint::loading_finished, this,
+          &View::loadingFinished);
+  connect(load_cancel, &QPushButton::clicked, ui->widget,
+          &Paint::cancelLoading);
+
   // Восстановление сохраненных настроек из файла настроек
   ui->projectionBox->setCurrentText(set->value("projection").toString());
   ui->lineBox->setCurrentText(set->value("lineType").toString());
@@ -53,24 +103,55 @@ s21::View::~View() {
 /**
  * @brief Обновляет информацию о модели на пользовательском интерфейсе.
  *
- * Эта функция принимает количество вершин, количество полигонов и имя файла
+ * Эта функция принимает количество вершин, полигонов, рёбер и имя файла
  * и обновляет соответствующие поля на пользовательском интерфейсе.
  *
  * @param verticesCount Количество вершин модели.
  * @param polygonsCount Количество полигонов модели.
+ * @param edgesCount Количество уникальных рёбер модели.
  * @param fileName Имя файла модели.
  */
 void s21::View::receiveInfo(int verticesCount, int polygonsCount,
-                            QString fileName) noexcept {
+                            int edgesCount, QString fileName) noexcept {
   // Установка текста на пользовательском интерфейсе
   ui->vertices->setText(QString::number(verticesCount));
   ui->polygons->setText(QString::number(polygonsCount));
+  ui->edges->setText(QString::number(edgesCount));
   ui->fileName->setText(fileName);
 
   // Обновление пользовательского интерфейса
   update();
 }
 
+/**
+ * @brief Отображает ход фоновой загрузки модели.
+ *
+ * Количество разобранных вершин и полигонов выводится в тексте индикатора,
+ * а не в полях информации, которые до окончания загрузки описывают прежнюю
+ * модель.
+ *
+ * @param percent Разобранная часть файла в процентах.
+ * @param verticesCount Количество разобранных вершин.
+ * @param polygonsCount Количество разобранных полигонов.
+ */
+void s21::View::receiveProgress(int percent, int verticesCount,
+                                int polygonsCount) noexcept {
+  load_progress->setValue(percent);
+  load_progress->setFormat(QString("%p% · вершин: %1 · полигонов: %2")
+                               .arg(verticesCount)
+                               .arg(polygonsCount));
+  load_progress->show();
+  load_cancel->show();
+}
+
+/**
+ * @brief Скрывает индикатор и кнопку отмены загрузки.
+ */
+void s21::View::loadingFinished() noexcept {
+  load_progress->hide();
+  load_cancel->hide();
+}
+
 /**
  * @brief Вызывается при нажатии на кнопку "Преобразовать модель".
  *
@@ -124,7 +205,9 @@ void s21::View::on_applySettings_clicked() noexcept {
  * Эта функция открывает диалоговое окно для выбора места и формата сохранения
  * изображения модели. После выбора места и формата, функция сохраняет
  * изображение модели с помощью метода `grabFramebuffer()` виджета и сохраняет
- * его в выбранное место с указанным форматом.
+ * его в выбранное место с указанным форматом. Окно всегда имеет контекст
+ * OpenGL, поэтому снимок берётся из его кадрового буфера; программный
+ * Rasterizer нужен только пакетному режиму (batch.cc), где контекста нет.
  *
  * @note Изображение сохраняется с максимальным качеством (качество 100).
  */
@@ -143,86 +226,294 @@ void s21::View::on_saveImage_clicked() noexcept {
 /**
  * @brief Вызывается при нажатии на кнопку "Запись GIF".
  *
- * Эта функция инициализирует процесс записи GIF-анимации. Она создает объекты
- * QGifImage для записи и QImage для временного хранения кадров. Также
- * устанавливается таймер, который будет вызывать функцию сохранения каждые 50
- * миллисекунд. Запись начинается после нажатия кнопки "Запись GIF".
+ * Эта функция предлагает пользователю выбрать место для сохранения
+ * GIF-анимации, открывает файл в GifRecorder и запускает таймер, который
+ * будет вызывать функцию сохранения каждые 50 миллисекунд. Повторное нажатие
+ * во время записи игнорируется. Кодировщик предыдущей записи, возможно ещё
+ * дописывающий файл, не ожидается (см. retireRecorder()).
  *
  * @note GIF-анимация будет записана с заданным интервалом в 50 миллисекунд
  * между кадрами. Вызывается слот save() при каждом таймере.
  */
 void s21::View::on_recordScreencast_clicked() {
-  // Инициализируем объекты для записи GIF
-  gif = new QGifImage;
-  frame = new QImage;
+  if (timer && timer->isActive()) return;
+
+  // Файл открывается до начала записи, чтобы кадры дописывались в него сразу
+  QString save = QFileDialog::getSaveFileName(this, NULL, NULL, "GIF (*.gif)");
+  if (save.isNull()) return;
+
+  retireRecorder();
+  recorder = std::make_unique<GifRecorder>(save, kFrameInterval);
+  if (!recorder->isOpen()) {
+    recorder.reset();
+    return;
+  }
 
   // Создаем и настраиваем таймер для записи каждые 50 миллисекунд
-  timer = new QTimer(this);
+  if (!timer) {
+    timer = new QTimer(this);
+    connect(timer, SIGNAL(timeout()), this, SLOT(save()));
+  }
   count = 0;
-  connect(timer, SIGNAL(timeout()), this, SLOT(save()));
-  timer->start(50);
+  timer->start(kFrameInterval);
 }
 
 /**
  * @brief Сохраняет кадры и создает GIF-анимацию.
  *
  * Эта функция вызывается таймером каждые 50 миллисекунд в процессе записи
- * GIF-анимации. Она увеличивает счетчик кадров, захватывает текущий кадр из
- * виджета `ui->widget`, добавляет его в GIF-анимацию и проверяет, достигло ли
- * количество сохраненных кадров максимального значения (50). Если это так, то
- * запись GIF-анимации останавливается и пользователю предлагается выбрать место
- * для сохранения анимации.
+ * GIF-анимации. Она увеличивает счетчик кадров, захватывает кадровый буфер
+ * виджета `ui->widget` методом `grabFramebuffer()` и передает его в очередь
+ * кодировщика, который в своём потоке переводит в палитру только
+ * изменившуюся с предыдущего кадра область, сжимает её и дописывает в файл.
+ * Если кодировщик не успевает, кадр пропускается, а не ждёт места в
+ * очереди. По достижении 50 кадров запись останавливается, а кодировщик
+ * дописывает оставшиеся кадры и закрывает файл без блокировки интерфейса;
+ * о пропущенных кадрах сообщается в строке состояния.
  *
  * @note GIF-анимация сохраняется с расширением .gif.
  */
 void s21::View::save() noexcept {
   count++;  // Увеличиваем счетчик кадров
 
-  // Захватываем текущий кадр из виджета и добавляем его в GIF-анимацию
-  *frame = ui->widget->grabFramebuffer();
-  gif->addFrame(*frame);
-
-  if (count == 50) {  // Если записано 50 кадров
-    timer->stop();    // Останавливаем таймер записи
-    QString save = NULL;
+  // Захватываем текущий кадр из виджета и передаем его кодировщику
+  recorder->addFrame(ui->widget->grabFramebuffer());
 
-    // Пользователю предлагается выбрать место для сохранения GIF-анимации
-    save = QFileDialog::getSaveFileName(this, NULL, NULL, "GIF (*.gif)");
-    if (!save.isNull()) gif->save(save);  // Сохраняем анимацию
+  if (count == kFrameCount) {  // Если записано 50 кадров
+    timer->stop();             // Останавливаем таймер записи
+    if (recorder->droppedFrames() != 0)
+      statusBar()->showMessage(
+          QString("GIF: пропущено кадров: %1").arg(recorder->droppedFrames()),
+          5000);
+    retireRecorder();
   }
 }
 
+/**
+ * @brief Завершение текущей записи GIF-анимации без ожидания кодировщика.
+ *
+ * Деструктор GifRecorder ждёт поток кодировщика, поэтому в потоке
+ * интерфейса удаляются только записи, уже закрывшие свой файл. Остальные
+ * дожидаются следующего вызова или закрытия окна.
+ */
+void s21::View::retireRecorder() {
+  retired_recorders.erase(
+      std::remove_if(retired_recorders.begin(), retired_recorders.end(),
+                     [](const std::unique_ptr<GifRecorder> &retired) {
+                       return retired->isFinished();
+                     }),
+      retired_recorders.end());
+  if (!recorder) return;
+  recorder->finish();
+  retired_recorders.push_back(std::move(recorder));
+}
+
 /**
  * @brief Конструктор класса Paint.
  *
+ * Сохранённые настройки отображения читаются и разбираются один раз.
+ * Разобранные модели кэшируются в каталоге пользователя; размер кэша
+ * ограничен MeshCache::kDefaultLimit.
+ *
  * @param parent Родительский виджет (по умолчанию - nullptr).
  */
 s21::Paint::Paint(QWidget *parent) : QOpenGLWidget{parent} {
   axis_check = 0;
-  set = new QSettings("launch_settings.init", QSettings::IniFormat);
+  xRot = yRot = zRot = 0;
+  QSettings settings(kSettingsFile, QSettings::IniFormat);
+  for (const auto &key : kSettingsKeys)
+    render.set(key[1], settings.value(key[1]).toString().toStdString());
+  controller.setCacheDirectory(MeshCache::defaultDirectory());
+  loading_timer = new QTimer(this);
+  connect(loading_timer, &QTimer::timeout, this, &Paint::pollLoading);
+}
+
+/**
+ * @brief Деструктор класса Paint.
+ *
+ * Отменяет фоновую загрузку модели и дожидается её и ранее отменённых
+ * загрузок, дожидается сохранения настроек, удаляет буферы видеопамяти в
+ * контексте виджета и освобождает ресурсы модели.
+ */
+s21::Paint::~Paint() {
+  cancelLoading();
+  if (loading.valid()) loading.wait();
+  for (std::future<LoadResult> &load : retired_loads) load.wait();
+  if (settings_saved.valid()) settings_saved.wait();
+  makeCurrent();
+  vertex_buffer.destroy();
+  line_buffer.destroy();
+  preview_buffer.destroy();
+  doneCurrent();
+  model.releaseResources();
+}
+
+/**
+ * @brief Инициализация контекста OpenGL.
+ *
+ * Создаёт буферы вершин, рёбер и предпросмотра загрузки и загружает в
+ * первые два текущую геометрию модели.
+ */
+void s21::Paint::initializeGL() {
+  vertex_buffer.create();
+  line_buffer.create();
+  preview_buffer.create();
+  uploadGeometry();
+}
+
+/**
+ * @brief Загрузка геометрии модели в буферы видеопамяти.
+ *
+ * Координаты вершин копируются в буфер вершин один раз без перепаковки.
+ * Уникальные рёбра, построенные при загрузке модели, загружаются парами
+ * индексов, чтобы весь каркас рисовался одним вызовом
+ * glDrawElements(GL_LINES) и каждое общее ребро рисовалось один раз. Слой
+ * точек рисуется прямо из буфера вершин.
+ */
+void s21::Paint::uploadGeometry() {
+  const Model::Data &data = model.viewer;
+  const std::vector<uint32_t> &lines = data.edges;
+
+  vertex_buffer.bind();
+  vertex_buffer.allocate(data.vertexes.data(),
+                         static_cast<int>(data.vertexes.size() * 3 *
+                                          sizeof(float)));
+  vertex_buffer.release();
+  line_buffer.bind();
+  line_buffer.allocate(lines.data(),
+                       static_cast<int>(lines.size() * sizeof(uint32_t)));
+  line_buffer.release();
+
+  line_indexes = static_cast<int>(lines.size());
+  point_count = static_cast<int>(data.vertexes.size());
+  uploaded_revision = model.geometryRevision();
+}
+
+/**
+ * @brief Загрузка вершин предпросмотра в видеопамять.
+ *
+ * Вершины предпросмотра только дописываются, поэтому в буфер записываются
+ * лишь скопированные после прошлого вызова. Буфер растёт удвоением, и
+ * только тогда вершины записываются в него заново. Вместимость сохраняется
+ * и для следующих загрузок.
+ */
+void s21::Paint::uploadPreview() {
+  constexpr std::size_t kVertexBytes = 3 * sizeof(float);
+  const std::size_t count = preview.vertexes.size();
+  if (count == preview_uploaded) return;
+  preview_buffer.bind();
+  if (count > preview_capacity) {
+    preview_capacity = std::max(count, preview_capacity * 2);
+    preview_buffer.allocate(static_cast<int>(preview_capacity * kVertexBytes));
+    preview_uploaded = 0;
+  }
+  preview_buffer.write(static_cast<int>(preview_uploaded * kVertexBytes),
+                       preview.vertexes.data() + preview_uploaded * 3,
+                       static_cast<int>((count - preview_uploaded) *
+                                        kVertexBytes));
+  preview_buffer.release();
+  preview_uploaded = count;
 }
 
 /**
  * @brief Обработчик события нажатия на кнопку "Выбрать файл".
  *
  * Эта функция вызывается при нажатии на кнопку "Выбрать файл" и открывает
- * диалоговое окно для выбора файла. Затем она передает путь к выбранному файлу
- * через контроллер модели для загрузки данных о модели, центрирует модель и
- * отправляет информацию о количестве вершин и полигонов модели в сигнал.
+ * диалоговое окно для выбора файла. Затем она запускает загрузку выбранного
+ * файла через контроллер в отдельном потоке в собственные данные, не
+ * затрагивая отображаемую модель, и таймер, который сообщает ход загрузки
+ * и по её окончании заменяет модель (см. pollLoading()). Незавершённая
+ * загрузка предыдущего файла отменяется и переносится в retired_loads:
+ * присваивание поверх future от std::async ждало бы завершения её потока в
+ * потоке интерфейса. Предпросмотр предыдущей загрузки сбрасывается.
  */
 void s21::Paint::on_SelectFileButton_clicked() noexcept {
-  QString f_name;
-
   QString filename = QFileDialog::getOpenFileName(this, "Выберите файл");
+  if (filename.isEmpty()) return;
+
+  cancelLoading();
+  if (loading.valid()) retired_loads.push_back(std::move(loading));
+  preview = Model::Data();
+  preview_uploaded = 0;
+  auto progress = std::make_shared<Model::Progress>();
+  progress->publish = true;
+  loading = std::async(
+      std::launch::async,
+      [this, path = filename.toLocal8Bit(), progress]() {
+        LoadResult data = std::make_unique<Model::Data>();
+        if (!controller.load(path.constData(), *data, progress.get()))
+          data.reset();
+        return data;
+      });
+  loading_progress = std::move(progress);
+  loading_name = filename.split('/').last();
+  loading_path = filename.toLocal8Bit();
+  loading_timer->start(kLoadingInterval);
+}
 
-  QByteArray ba = filename.toLocal8Bit();
-  const char *filename_c = ba.data();
-  controller.coreParser(filename_c);
-  controller.setInCenter();
-  f_name = filename.split('/').last();
+/**
+ * @brief Отменяет фоновую загрузку модели.
+ *
+ * Поток загрузки прекращает разбор при ближайшей проверке запроса отмены;
+ * его результат забирает pollLoading().
+ */
+void s21::Paint::cancelLoading() noexcept {
+  if (loading_progress) loading_progress->cancelled = true;
+}
+
+/**
+ * @brief Проверяет фоновую загрузку модели.
+ *
+ * Пока загрузка идёт, уже разобранные вершины копируются в preview и
+ * рисуются вместо модели, а сама модель не изменяется. Загруженные данные
+ * перемещаются в модель одним присваиванием в потоке интерфейса, после чего
+ * модель центрируется, запись её копии в кэш запускается в пуле потоков, а
+ * информация о ней передаётся в сигнал. После
+ * окончания загрузки предпросмотр освобождается, и если загрузка не удалась
+ * или была отменена, снова рисуется прежняя модель.
+ *
+ * Отменённые загрузки, заменённые новой, удаляются по мере завершения их
+ * потоков; таймер работает, пока не завершатся все загрузки.
+ */
+void s21::Paint::pollLoading() {
+  retired_loads.erase(
+      std::remove_if(retired_loads.begin(), retired_loads.end(),
+                     [](const std::future<LoadResult> &load) {
+                       return load.wait_for(std::chrono::seconds(0)) ==
+                              std::future_status::ready;
+                     }),
+      retired_loads.end());
+  if (!loading.valid()) {
+    if (retired_loads.empty()) loading_timer->stop();
+    return;
+  }
+  Model::Progress &progress = *loading_progress;
+  if (loading.wait_for(std::chrono::seconds(0)) !=
+      std::future_status::ready) {
+    uint64_t total = std::max<uint64_t>(progress.total, 1);
+    emit send_progress(static_cast<int>(progress.bytes * 100 / total),
+                       static_cast<int>(progress.vertexes),
+                       static_cast<int>(progress.polygons));
+    if (controller.copyPreview(progress, preview)) update();
+    return;
+  }
+
+  if (retired_loads.empty()) loading_timer->stop();
+  LoadResult data = loading.get();
+  loading_progress.reset();
+  preview = Model::Data();
+  preview_uploaded = 0;
+  emit loading_finished();
+  if (!data) {
+    update();
+    return;
+  }
 
+  controller.replace(std::move(*data));
+  controller.setInCenter();
+  controller.storeCache(loading_path.constData());
   emit send_info(model.viewer.count_of_vertexes, model.viewer.count_of_polygons,
-                 f_name);
+                 model.viewer.count_of_edges, loading_name);
   update();
 }
 
@@ -247,33 +538,21 @@ void s21::Paint::on_checkAxes_clicked() noexcept {
  *
  * Эта функция выполняет отрисовку 3D-объекта в контексте OpenGL. Она использует
  * данные, хранящиеся в классе Model, а также настройки интерфейса для
- * управления отображением объекта. Сначала функция устанавливает цвет фона
- * сцены в соответствии с выбранным цветом из настроек. Затем она настраивает
- * проекцию в зависимости от выбранного типа проекции (центральная или
- * ортографическая). После этого функция выполняет отрисовку объекта, вращение
- * и масштабирование согласно текущим параметрам. Если установлен режим
- * отображения осей, функция также отрисовывает оси координат.
+ * управления отображением объекта. Настройки берутся из уже разобранной
+ * структуры render, без обращения к QSettings. Сначала функция устанавливает
+ * цвет фона сцены в соответствии с выбранным цветом из настроек. Затем она
+ * настраивает проекцию в зависимости от выбранного типа проекции (центральная
+ * или ортографическая). После этого функция выполняет отрисовку объекта,
+ * вращение и масштабирование согласно текущим параметрам и матрице модели.
+ * Если установлен режим отображения осей, функция также отрисовывает оси
+ * координат. Вершины не рисуются, если выбран способ отображения "None".
  */
 void s21::Paint::paintGL() {
-  background_color = set->value("backgroundColor").toString();
-  if (background_color == "Red")
-    glClearColor(1, 0.0, 0.0, 0.0);
-  else if (background_color == "Green")
-    glClearColor(0, 1, 0.0, 0.0);
-  else if (background_color == "Blue")
-    glClearColor(0, 0.0, 1, 0.0);
-  else if (background_color == "Yellow")
-    glClearColor(1, 1, 0.0, 0);
-  else if (background_color == "Pink")
-    glClearColor(1, 0, 1, 0);
-  else if (background_color == "White")
-    glClearColor(1, 1, 1, 1);
-  else
-    glClearColor(0, 0.0, 0.0, 0.0);
+  const RenderSettings::Color &background = render.background_color;
+  glClearColor(background.r, background.g, background.b, background.a);
   glMatrixMode(GL_PROJECTION);
   glLoadIdentity();
-  projection_type = set->value("projection").toString();
-  if (projection_type == "Central")
+  if (render.projection == RenderSettings::Projection::kCentral)
     glFrustum(-2, +2, -2, +2, 5.0, 15.0);
   else
     glOrtho(-2, +2, -2, +2, 1.0, 15.0);
@@ -285,9 +564,39 @@ void s21::Paint::paintGL() {
   glRotatef(xRot / 16.0, 1.0, 0.0, 0.0);
   glRotatef(yRot / 16.0, 0.0, 1.0, 0.0);
   glRotatef(zRot / 16.0, 0.0, 0.0, 1.0);
-  drawLines();
-  drawPoints();
-  vertex_display = set->value("vertexDisplay").toString();
+
+  // Вершины модели не изменяются преобразованиями: накопленная матрица
+  // модели применяется здесь, поэтому масштабирование и повороты не требуют
+  // прохода по вершинам. Пока идёт загрузка, вместо модели рисуются уже
+  // разобранные вершины из отдельного буфера, а модель не изменяется до
+  // окончания загрузки.
+  const bool previewing = loading_progress && !preview.vertexes.empty();
+  GLfloat model_matrix[16];
+  (previewing ? preview : model.viewer).matrix.toColumnMajor(model_matrix);
+  glPushMatrix();
+  glMultMatrixf(model_matrix);
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  if (previewing) {
+    // Предпросмотр ещё не имеет рёбер и всегда рисуется точками
+    uploadPreview();
+    preview_buffer.bind();
+    glVertexPointer(3, GL_FLOAT, 0, nullptr);
+    preview_buffer.release();
+    drawPoints(static_cast<int>(preview_uploaded));
+  } else {
+    // Геометрия загружается в видеопамять только после её изменения, а оба
+    // слоя рисуются из одного буфера вершин.
+    if (uploaded_revision != model.geometryRevision()) uploadGeometry();
+    vertex_buffer.bind();
+    glVertexPointer(3, GL_FLOAT, 0, nullptr);
+    vertex_buffer.release();
+    drawLines();
+    if (render.vertex_display != RenderSettings::PointShape::kNone)
+      drawPoints(point_count);
+  }
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glPopMatrix();
 
   if (axis_check != 0) drawAxis();
 }
@@ -300,41 +609,20 @@ void s21::Paint::paintGL() {
  * Сначала функция устанавливает цвет линий в соответствии с выбранным цветом
  * из настроек интерфейса. Затем она определяет тип линии (сплошная или пунктир)
  * и устанавливает соответствующие параметры OpenGL. Толщина линии также берется
- * из настроек. Далее функция итерируется по полигонам объекта и отрисовывает
- * линии для каждого полигона, соединяя его вершины.
+ * из настроек. Далее все рёбра полигонов рисуются одним вызовом
+ * glDrawElements() из буферов, загруженных в uploadGeometry().
  */
 void s21::Paint::drawLines() noexcept {
-  line_color = set->value("lineColor").toString();
-  if (line_color == "Red")
-    glColor3d(1, 0, 0);
-  else if (line_color == "Green")
-    glColor3d(0, 1, 0);
-  else if (line_color == "Blue")
-    glColor3d(0, 0, 1);
-  else
-    glColor3d(1, 1, 1);
-  line_type = set->value("lineType").toString();
-  if (line_type == "Dashed") {
+  glColor4fv(render.line_color.data());
+  if (render.line_type == RenderSettings::LineType::kDashed) {
     glEnable(GL_LINE_STIPPLE);
     glLineStipple(1, 0X00FF);
   } else
     glDisable(GL_LINE_STIPPLE);
-  line_width = set->value("lineWidth").toInt();
-  glLineWidth(line_width);
-  for (int i = 1; i < model.viewer.count_of_polygons + 1; i++) {
-    for (int j = 0;
-         j < model.viewer.array_of_polygon[i].numbers_of_vertexes_for_polygon;
-         j++) {
-      glBegin(GL_LINE_LOOP);
-      glVertex3d(model.viewer.matrix_of_vertexes
-                     .matrix[model.viewer.array_of_polygon[i].vertexes[j]][0],
-                 model.viewer.matrix_of_vertexes
-                     .matrix[model.viewer.array_of_polygon[i].vertexes[j]][1],
-                 model.viewer.matrix_of_vertexes
-                     .matrix[model.viewer.array_of_polygon[i].vertexes[j]][2]);
-    }
-    glEnd();
-  }
+  glLineWidth(render.line_width);
+  line_buffer.bind();
+  glDrawElements(GL_LINES, line_indexes, GL_UNSIGNED_INT, nullptr);
+  line_buffer.release();
 }
 
 /**
@@ -345,42 +633,22 @@ void s21::Paint::drawLines() noexcept {
  * Сначала функция устанавливает цвет точек в соответствии с выбранным цветом
  * из настроек интерфейса. Затем она определяет размер и тип отображения точек
  * (квадратные или сглаженные) и устанавливает соответствующие параметры OpenGL.
- * Далее функция итерируется по полигонам объекта и отрисовывает точки для
- * каждой вершины полигона.
- */
-void s21::Paint::drawPoints() noexcept {
-  vertex_color = set->value("vertexColor").toString();
-  if (vertex_color == "Red")
-    glColor3d(1, 0, 0);
-  else if (vertex_color == "Green")
-    glColor3d(0, 1, 0);
-  else if (vertex_color == "Blue")
-    glColor3d(0, 0, 1);
-  else
-    glColor3d(1, 1, 1);
+ * Далее каждая вершина модели рисуется ровно одной точкой: весь буфер вершин
+ * выводится одним вызовом glDrawArrays() без индексов, поэтому вершины, общие
+ * для нескольких полигонов, не повторяются, а вершины вне полигонов тоже
+ * видны.
+ */
+void s21::Paint::drawPoints(int count) noexcept {
+  glColor4fv(render.vertex_color.data());
 
   glEnable(GL_BLEND);
-  if (vertex_display == "Square")
+  if (render.vertex_display == RenderSettings::PointShape::kSquare)
     glDisable(GL_POINT_SMOOTH);
   else
     glEnable(GL_POINT_SMOOTH);
-  vertex_size = set->value("vertexSize").toInt();
   glEnable(GL_PROGRAM_POINT_SIZE);
-  glPointSize(vertex_size);
-  for (int i = 1; i < model.viewer.count_of_polygons + 1; i++) {
-    for (int j = 0;
-         j < model.viewer.array_of_polygon[i].numbers_of_vertexes_for_polygon;
-         j++) {
-      glBegin(GL_POINTS);
-      glVertex3d(model.viewer.matrix_of_vertexes
-                     .matrix[model.viewer.array_of_polygon[i].vertexes[j]][0],
-                 model.viewer.matrix_of_vertexes
-                     .matrix[model.viewer.array_of_polygon[i].vertexes[j]][1],
-                 model.viewer.matrix_of_vertexes
-                     .matrix[model.viewer.array_of_polygon[i].vertexes[j]][2]);
-    }
-    glEnd();
-  }
+  glPointSize(render.vertex_size);
+  glDrawArrays(GL_POINTS, 0, count);
 }
 
 /**
@@ -556,33 +824,48 @@ void s21::Paint::scaleModel(float scaleFactor) noexcept {
 /**
  * @brief Обработчик нажатия кнопки применения настроек интерфейса.
  *
- * Функция применяет измененные пользователем настройки интерфейса и сохраняет
- * их. Также функция обновляет изображение модели с учетом новых настроек.
+ * Функция один раз разбирает измененные пользователем настройки в структуру
+ * render, которую читает отрисовка, и сохраняет их в файл асинхронно. Также
+ * функция обновляет изображение модели с учетом новых настроек.
  *
  * @param[in] map Карта настроек с ключами и значениями.
  */
 void s21::Paint::on_applySettingsButton_clicked(
     QMap<QString, QString> map) noexcept {
   // Применение настроек
-  projection_type = map["projection"];
-  line_type = map["line_type"];
-  line_color = map["line_color"];
-  line_width = map["line_width"].toInt();
-  vertex_color = map["vertex_color"];
-  vertex_size = map["vertex_size"].toInt();
-  vertex_display = map["vertex_display"];
-  background_color = map["background_color"];
+  QMap<QString, QString> values;
+  for (const auto &key : kSettingsKeys) {
+    const QString &value = map[key[0]];
+    render.set(key[1], value.toStdString());
+    values[key[1]] = value;
+  }
 
   // Сохранение настроек в файл
-  set->setValue("projection", map["projection"]);
-  set->setValue("lineType", map["line_type"]);
-  set->setValue("lineColor", map["line_color"]);
-  set->setValue("lineWidth", map["line_width"]);
-  set->setValue("vertexColor", map["vertex_color"]);
-  set->setValue("vertexSize", map["vertex_size"]);
-  set->setValue("vertexDisplay", map["vertex_display"]);
-  set->setValue("backgroundColor", map["background_color"]);
+  persistSettings(values);
 
   // Обновление изображения
   update();
 }
+
+/**
+ * @brief Асинхронное сохранение настроек в файл.
+ *
+ * Каждая запись получает номер; задача пула записывает файл под мьютексом
+ * и только если её номер последний, поэтому файл не может быть перезаписан
+ * устаревшими настройками, а серия быстрых изменений даёт одну запись.
+ *
+ * @param[in] values Значения настроек по ключам файла настроек.
+ */
+void s21::Paint::persistSettings(QMap<QString, QString> values) {
+  std::shared_ptr<SettingsWriter> writer = settings_writer;
+  uint64_t generation = ++writer->generation;
+  settings_saved = ThreadPool::getInstance().submit([writer, generation,
+                                                     values]() {
+    std::lock_guard<std::mutex> lock(writer->mutex);
+    if (generation != writer->generation.load()) return;
+    QSettings settings(kSettingsFile, QSettings::IniFormat);
+    for (auto it = values.cbegin(); it != values.cend(); ++it)
+      settings.setValue(it.key(), it.value());
+    settings.sync();
+  });
+}
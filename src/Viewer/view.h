@@ -11,12 +11,23 @@
 
 #include <QImage>
 #include <QMainWindow>
+#include <QOpenGLBuffer>
 #include <QOpenGLWidget>
+#include <QProgressBar>
+#include <QPushButton>
 #include <QSettings>
+#include <QTimer>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "controller.h"
+#include "gif_recorder.h"
 #include "model.h"
-#include "qgifimage.h"
+#include "render_settings.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -78,11 +89,33 @@ class View : public QMainWindow {
    *
    * @param verticesСount Количество вершин в модели.
    * @param polygonsСount Количество полигонов в модели.
+   * @param edgesCount Количество уникальных рёбер в модели.
    * @param fileName Имя файла модели.
    */
-  void receiveInfo(int verticesСount, int polygonsСount,
+  void receiveInfo(int verticesСount, int polygonsСount, int edgesCount,
                    QString fileName) noexcept;
 
+  /**
+   * @brief Слот для отображения хода загрузки модели.
+   *
+   * Показывает в строке состояния индикатор и кнопку отмены загрузки, а
+   * количество уже разобранных вершин и полигонов — в полях информации о
+   * модели.
+   *
+   * @param percent Разобранная часть файла в процентах.
+   * @param verticesCount Количество разобранных вершин.
+   * @param polygonsCount Количество разобранных полигонов.
+   */
+  void receiveProgress(int percent, int verticesCount,
+                       int polygonsCount) noexcept;
+
+  /**
+   * @brief Слот завершения загрузки модели.
+   *
+   * Скрывает индикатор загрузки и кнопку отмены.
+   */
+  void loadingFinished() noexcept;
+
  private slots:
   /**
    * @brief Слот для обработки нажатия кнопки "Преобразовать".
@@ -121,19 +154,30 @@ class View : public QMainWindow {
    * @brief Слот для сохранения кадров и создания GIF-анимации.
    *
    * Этот слот вызывается таймером каждые 50 миллисекунд в процессе записи
-   * GIF-анимации. Он увеличивает счетчик кадров, захватывает текущий кадр из
-   * виджета и добавляет его в GIF-анимацию. По достижении максимального
-   * количества сохраненных кадров (50), запись GIF-анимации останавливается и
-   * пользователю предлагается выбрать место для сохранения.
+   * GIF-анимации. Он увеличивает счетчик кадров, отрисовывает текущий кадр
+   * виджета и передает его кодировщику GIF-анимации. По достижении
+   * максимального количества сохраненных кадров (50), запись GIF-анимации
+   * останавливается.
    */
   void save() noexcept;
 
  private:
+  /**
+   * @brief Завершение текущей записи GIF-анимации без ожидания кодировщика.
+   *
+   * Запись переносится в retired_recorders и удаляется при следующем вызове,
+   * когда её кодировщик закроет файл.
+   */
+  void retireRecorder();
+
   Ui::View *ui; /**< Указатель на интерфейс главного окна. */
   QSettings *set; /**< Указатель на настройки приложения. */
-  QGifImage *gif; /**< Указатель на GIF-анимацию. */
-  QImage *frame;  /**< Указатель на кадр анимации. */
-  QTimer *timer; /**< Указатель на таймер записи GIF-анимации. */
+  QProgressBar *load_progress; /**< Ход загрузки модели. */
+  QPushButton *load_cancel; /**< Кнопка отмены загрузки модели. */
+  std::unique_ptr<GifRecorder> recorder; /**< Запись GIF-анимации. */
+  std::vector<std::unique_ptr<GifRecorder>>
+      retired_recorders; /**< Завершённые записи, ещё дописывающие файл. */
+  QTimer *timer = nullptr; /**< Указатель на таймер записи GIF-анимации. */
   int count; /**< Счетчик сохраненных кадров GIF-анимации. */
 };
 
@@ -158,9 +202,9 @@ class Paint : public QOpenGLWidget {
   /**
    * @brief Деструктор класса Paint.
    *
-   * Освобождает ресурсы модели при уничтожении объекта.
+   * Освобождает буферы видеопамяти и ресурсы модели при уничтожении объекта.
    */
-  ~Paint() { model.releaseResources(); }
+  ~Paint();
 
   /**
    * @brief Отрисовать линии объекта.
@@ -169,8 +213,10 @@ class Paint : public QOpenGLWidget {
 
   /**
    * @brief Отрисовать точки объекта.
+   *
+   * @param count Количество вершин в текущем буфере вершин.
    */
-  void drawPoints() noexcept;
+  void drawPoints(int count) noexcept;
 
   /**
    * @brief Отрисовать оси координат.
@@ -208,9 +254,19 @@ class Paint : public QOpenGLWidget {
 
   /**
    * @brief Обработчик нажатия кнопки выбора файла модели.
+   *
+   * Запускает загрузку выбранного файла в фоновом потоке; до её окончания
+   * отображается и преобразуется прежняя модель.
    */
   void on_SelectFileButton_clicked() noexcept;
 
+  /**
+   * @brief Отмена фоновой загрузки модели.
+   *
+   * Прежняя модель остаётся на экране.
+   */
+  void cancelLoading() noexcept;
+
   /**
    * @brief Обработчик нажатия кнопки проверки отображения осей.
    */
@@ -229,11 +285,34 @@ class Paint : public QOpenGLWidget {
    *
    * @param[in] vertices_count Количество вершин в модели.
    * @param[in] polygons_count Количество полигонов в модели.
+   * @param[in] edges_count Количество уникальных рёбер в модели.
    * @param[in] f_name Имя файла модели.
    */
-  void send_info(int vertices_count, int polygons_count, QString f_name);
+  void send_info(int vertices_count, int polygons_count, int edges_count,
+                 QString f_name);
+
+  /**
+   * @brief Сигнал о ходе фоновой загрузки модели.
+   *
+   * @param[in] percent Разобранная часть файла в процентах.
+   * @param[in] vertices_count Количество разобранных вершин.
+   * @param[in] polygons_count Количество разобранных полигонов.
+   */
+  void send_progress(int percent, int vertices_count, int polygons_count);
+
+  /**
+   * @brief Сигнал о завершении или отмене фоновой загрузки модели.
+   */
+  void loading_finished();
 
  protected:
+  /**
+   * @brief Переопределенная функция инициализации контекста OpenGL.
+   *
+   * Создаёт буферы вершин и индексов в видеопамяти.
+   */
+  void initializeGL() override;
+
   /**
    * @brief Переопределенная функция отрисовки сцены.
    */
@@ -268,23 +347,89 @@ class Paint : public QOpenGLWidget {
   void scaleModel(float scaleFactor) noexcept;
 
  private:
+  /**
+   * @brief Загрузка геометрии модели в буферы видеопамяти.
+   *
+   * Вызывается из paintGL() только если геометрия модели изменилась с
+   * прошлой загрузки (см. Model::geometryRevision()).
+   */
+  void uploadGeometry();
+
+  /**
+   * @brief Загрузка в видеопамять вершин предпросмотра, скопированных после
+   * прошлой загрузки.
+   */
+  void uploadPreview();
+
+  /**
+   * @brief Асинхронное сохранение настроек в файл.
+   *
+   * Запись выполняется в потоке пула; если до её начала настройки изменились
+   * снова, устаревшая запись пропускается.
+   *
+   * @param[in] values Значения настроек по ключам файла настроек.
+   */
+  void persistSettings(QMap<QString, QString> values);
+
+  /**
+   * @brief Проверка фоновой загрузки модели по таймеру.
+   *
+   * Пока загрузка идёт, сообщает её ход и копирует уже разобранные вершины
+   * в preview; после окончания заменяет модель загруженной в потоке
+   * интерфейса, поэтому отрисовка никогда не видит модель в промежуточном
+   * состоянии.
+   */
+  void pollLoading();
+
+  /**
+   * @brief Результат фоновой загрузки: nullptr, если она не удалась или
+   * была отменена.
+   */
+  using LoadResult = std::unique_ptr<Model::Data>;
+
+  /**
+   * @brief Состояние асинхронного сохранения настроек.
+   *
+   * Разделяется с задачами пула, поэтому задача может завершиться и после
+   * уничтожения виджета.
+   */
+  struct SettingsWriter {
+    std::mutex mutex;                     ///< Очерёдность записи в файл.
+    std::atomic<uint64_t> generation{0};  ///< Номер последних настроек.
+  };
+
   s21::Model &model =
       s21::Model::getInstance(); /**< Ссылка на объект модели. */
   s21::Controller controller; /**< Объект контроллера. */
-  QString projection_type;    /**< Тип проекции. */
-  QString line_type;          /**< Тип линии. */
-  QString line_color;         /**< Цвет линии. */
-  int line_width;             /**< Ширина линии. */
-  QString vertex_color;       /**< Цвет вершин. */
-  QString vertex_display; /**< Способ отображения вершин. */
-  int vertex_size;        /**< Размер вершин. */
+  RenderSettings render;      /**< Разобранные настройки отображения. */
+  std::shared_ptr<SettingsWriter> settings_writer =
+      std::make_shared<SettingsWriter>(); /**< Сохранение настроек. */
+  std::future<void> settings_saved; /**< Последняя запись настроек. */
+  std::future<LoadResult> loading; /**< Фоновая загрузка модели. */
+  std::vector<std::future<LoadResult>>
+      retired_loads; /**< Отменённые загрузки, ещё не завершившиеся. */
+  std::shared_ptr<Model::Progress>
+      loading_progress; /**< Ход фоновой загрузки модели. */
+  QString loading_name;  /**< Имя загружаемого файла. */
+  QByteArray loading_path; /**< Путь к загружаемому файлу. */
+  QTimer *loading_timer; /**< Таймер проверки загрузки. */
   int axis_check; /**< Переключатель отображения осей. */
-  QString background_color; /**< Цвет фона. */
-  QSettings *set;           /**< Настройки интерфейса. */
   int xRot;                 /**< Угол вращения по оси X. */
   int yRot;                 /**< Угол вращения по оси Y. */
   int zRot;                 /**< Угол вращения по оси Z. */
   QPoint lastPos;           /**< Последняя позиция мыши. */
+  QOpenGLBuffer vertex_buffer{
+      QOpenGLBuffer::VertexBuffer}; /**< Координаты вершин модели. */
+  QOpenGLBuffer line_buffer{
+      QOpenGLBuffer::IndexBuffer}; /**< Пары индексов уникальных рёбер. */
+  int line_indexes = 0;  /**< Количество индексов в line_buffer. */
+  int point_count = 0;   /**< Количество вершин в vertex_buffer. */
+  uint64_t uploaded_revision = 0; /**< Версия загруженной геометрии. */
+  Model::Data preview; /**< Вершины, разобранные фоновой загрузкой. */
+  QOpenGLBuffer preview_buffer{
+      QOpenGLBuffer::VertexBuffer}; /**< Координаты вершин предпросмотра. */
+  std::size_t preview_capacity = 0; /**< Вместимость preview_buffer. */
+  std::size_t preview_uploaded = 0; /**< Вершин в preview_buffer. */
 };
 }  // namespace s21
 #endif  // CPP4_3DVIEWER_V2_VIEWER_VIEW_H_
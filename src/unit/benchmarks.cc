@@ -0,0 +1,308 @@
+/*!
+\file
+\brief Замеры скорости и качества перевода кадров просмотрщика в палитру.
+
+Кадры отрисовываются программным растеризатором при повороте модели, как
+при записи GIF-анимации, и переводятся в палитру из 256 цветов медианным
+сечением giflib (GifQuantizeBuffer) и октодеревом ColorQuantizer. Для
+каждого способа выводится время на кадр и PSNR относительно исходного
+кадра. Сглаженные кадры получаются усреднением блоков 2x2 кадра двойного
+размера и содержат промежуточные оттенки, как кадры OpenGL со сглаживанием;
+в кадрах с градиентом фон заменяется плавным переходом цветов, и цветов в
+кадре становится заметно больше 256.
+
+Переведённые в общую палитру кадры затем сжимаются LZW-кодировщиком giflib
+(EGifPutLine) в память; выводятся время сжатия кадра и размер результата.
+
+Отдельно сравнивается загрузка модели: разбор файла .obj, загрузка из
+двоичного кэша MeshCache и одно отображение файла кэша в память с чтением
+каждой страницы. Последнее — нижняя граница для загрузки без копирования;
+разница с загрузкой из кэша — цена копирования массивов в данные модели.
+Все проходы выполняются с файлами в кэше страниц.
+
+Запуск: make benchmark [MODEL=obj_models/Wolf_obj.obj]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../Viewer/color_quantizer.h"
+#include "../Viewer/mapped_file.h"
+#include "../Viewer/mesh_cache.h"
+#include "../Viewer/model.h"
+#include "../Viewer/rasterizer.h"
+#include "../Viewer/render_settings.h"
+
+extern "C" {
+#include "../Viewer/QtGifImage/src/3rdParty/giflib/gif_lib.h"
+}
+
+namespace {
+
+constexpr int kWidth = 640;
+constexpr int kHeight = 480;
+constexpr int kFrames = 36;
+constexpr int kLzwPasses = 5;
+constexpr int kLoadPasses = 5;
+
+using Clock = std::chrono::steady_clock;
+using Frame = std::vector<uint32_t>;
+
+/**
+ * @brief Отрисовка кадров поворота модели вокруг оси Y.
+ *
+ * @param scale 1 — обычные кадры, 2 — сглаженные усреднением 2x2.
+ */
+std::vector<Frame> renderFrames(const s21::Model::Data &data, int scale) {
+  s21::RenderSettings render;
+  render.projection = s21::RenderSettings::Projection::kCentral;
+  render.line_color = {1, 1, 0, 1};
+  render.background_color = {0.1f, 0.1f, 0.3f, 1};
+  render.vertex_display = s21::RenderSettings::PointShape::kCircle;
+  render.vertex_color = {1, 0, 0, 1};
+  render.vertex_size = 3;
+
+  s21::Rasterizer rasterizer(kWidth * scale, kHeight * scale);
+  std::vector<Frame> frames;
+  for (int i = 0; i < kFrames; ++i) {
+    double angle = i * 360.0 / kFrames;
+    rasterizer.render(data, render,
+                      s21::Rasterizer::sceneRotation(20, angle, 0),
+                      s21::Model::centering(data), true);
+    Frame frame(kWidth * kHeight);
+    const uint32_t *pixels = rasterizer.pixels();
+    for (int y = 0; y < kHeight; ++y) {
+      for (int x = 0; x < kWidth; ++x) {
+        uint32_t sum[3] = {0, 0, 0};
+        for (int dy = 0; dy < scale; ++dy)
+          for (int dx = 0; dx < scale; ++dx) {
+            uint32_t p = pixels[(y * scale + dy) * kWidth * scale +
+                                x * scale + dx];
+            for (int c = 0; c < 3; ++c) sum[c] += p >> (16 - 8 * c) & 0xFF;
+          }
+        uint32_t n = scale * scale;
+        frame[y * kWidth + x] = 0xFF000000u | sum[0] / n << 16 |
+                                sum[1] / n << 8 | sum[2] / n;
+      }
+    }
+    frames.push_back(std::move(frame));
+  }
+  return frames;
+}
+
+/**
+ * @brief Замена фона кадров плавным переходом цветов.
+ */
+void addGradient(std::vector<Frame> &frames) {
+  const uint32_t background = frames.front()[0];
+  for (Frame &frame : frames)
+    for (int y = 0; y < kHeight; ++y)
+      for (int x = 0; x < kWidth; ++x)
+        if (frame[y * kWidth + x] == background)
+          frame[y * kWidth + x] = 0xFF000000u | (x * 255 / kWidth) << 16 |
+                                  (y * 255 / kHeight) << 8 |
+                                  ((x + y) * 255 / (kWidth + kHeight));
+}
+
+/**
+ * @brief PSNR кадра, восстановленного по индексам и палитре.
+ */
+double psnr(const Frame &frame, const std::vector<uint8_t> &indexes,
+            const std::vector<uint32_t> &palette) {
+  double error = 0;
+  for (std::size_t i = 0; i < frame.size(); ++i) {
+    for (int shift = 0; shift <= 16; shift += 8) {
+      double d = static_cast<double>(frame[i] >> shift & 0xFF) -
+                 static_cast<double>(palette[indexes[i]] >> shift & 0xFF);
+      error += d * d;
+    }
+  }
+  error /= frame.size() * 3.0;
+  return error == 0 ? INFINITY : 10 * std::log10(255.0 * 255.0 / error);
+}
+
+/**
+ * @brief Медианное сечение giflib, палитра строится для каждого кадра.
+ */
+void benchmarkGiflib(const std::vector<Frame> &frames) {
+  std::vector<GifByteType> red(kWidth * kHeight), green(red.size()),
+      blue(red.size());
+  std::vector<uint8_t> indexes(red.size());
+  double seconds = 0, quality = 0;
+  for (const Frame &frame : frames) {
+    for (std::size_t i = 0; i < frame.size(); ++i) {
+      red[i] = frame[i] >> 16 & 0xFF;
+      green[i] = frame[i] >> 8 & 0xFF;
+      blue[i] = frame[i] & 0xFF;
+    }
+    GifColorType map[256];
+    int size = 256;
+    Clock::time_point start = Clock::now();
+    GifQuantizeBuffer(kWidth, kHeight, &size, red.data(), green.data(),
+                      blue.data(), indexes.data(), map);
+    seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    std::vector<uint32_t> palette(256);
+    for (int i = 0; i < size; ++i)
+      palette[i] = 0xFF000000u | map[i].Red << 16 | map[i].Green << 8 |
+                   map[i].Blue;
+    quality += psnr(frame, indexes, palette);
+  }
+  std::printf("  giflib median cut     %8.2f ms/frame  PSNR %6.2f dB\n",
+              seconds * 1000 / frames.size(), quality / frames.size());
+}
+
+/**
+ * @brief Октодерево: палитра по первому кадру или по каждому кадру.
+ */
+void benchmarkOctree(const std::vector<Frame> &frames, bool shared,
+                     s21::ColorQuantizer::Dither dither, const char *name) {
+  s21::ColorQuantizer quantizer(s21::ColorQuantizer::kMaxColors, dither);
+  std::vector<uint8_t> indexes(kWidth * kHeight);
+  double seconds = 0, quality = 0;
+  for (const Frame &frame : frames) {
+    Clock::time_point start = Clock::now();
+    if (!shared || !quantizer.hasPalette())
+      quantizer.buildPalette(frame.data(), kWidth, kHeight, kWidth);
+    quantizer.map(frame.data(), kWidth, kHeight, kWidth, indexes.data(),
+                  kWidth);
+    seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    quality += psnr(frame, indexes, quantizer.palette());
+  }
+  std::printf("  %-21s %8.2f ms/frame  PSNR %6.2f dB\n", name,
+              seconds * 1000 / frames.size(), quality / frames.size());
+}
+
+/**
+ * @brief Запись сжатых данных в вектор (см. EGifOpen()).
+ */
+int writeToVector(GifFileType *file, const GifByteType *data, int size) {
+  auto *out = static_cast<std::vector<GifByteType> *>(file->UserData);
+  out->insert(out->end(), data, data + size);
+  return size;
+}
+
+/**
+ * @brief Сжатие кадров, переведённых в общую палитру, кодировщиком giflib.
+ */
+void benchmarkLzw(const std::vector<Frame> &frames) {
+  s21::ColorQuantizer quantizer;
+  std::vector<std::vector<GifByteType>> indexed;
+  for (const Frame &frame : frames) {
+    indexed.emplace_back(frame.size());
+    quantizer.map(frame.data(), kWidth, kHeight, kWidth,
+                  indexed.back().data(), kWidth);
+  }
+  std::vector<GifColorType> colors(256);
+  for (std::size_t i = 0; i < quantizer.palette().size(); ++i)
+    colors[i] = {static_cast<GifByteType>(quantizer.palette()[i] >> 16),
+                 static_cast<GifByteType>(quantizer.palette()[i] >> 8),
+                 static_cast<GifByteType>(quantizer.palette()[i])};
+
+  // Сжатие быстрое, поэтому берётся лучший из нескольких проходов
+  std::vector<GifByteType> out, line(kWidth);
+  double best = INFINITY;
+  std::size_t bytes = 0;
+  for (int pass = 0; pass < kLzwPasses; ++pass) {
+    double seconds = 0;
+    bytes = 0;
+    for (const std::vector<GifByteType> &pixels : indexed) {
+      out.clear();
+      Clock::time_point start = Clock::now();
+      int error = 0;
+      GifFileType *file = EGifOpen(&out, writeToVector, &error);
+      file->SColorMap = GifMakeMapObject(256, colors.data());
+      EGifPutImageDesc(file, 0, 0, kWidth, kHeight, false, nullptr);
+      for (int y = 0; y < kHeight; ++y) {
+        std::copy(pixels.begin() + y * kWidth,
+                  pixels.begin() + (y + 1) * kWidth, line.begin());
+        EGifPutLine(file, line.data(), kWidth);
+      }
+      EGifCloseFile(file);
+      seconds += std::chrono::duration<double>(Clock::now() - start).count();
+      bytes += out.size();
+    }
+    best = std::min(best, seconds);
+  }
+  std::printf("  giflib LZW            %8.2f ms/frame  %6.1f KB/frame\n",
+              best * 1000 / frames.size(), bytes / 1024.0 / frames.size());
+}
+
+/**
+ * @brief Лучшее из kLoadPasses время выполнения load в миллисекундах.
+ */
+template <typename Load>
+double bestLoadTime(Load load) {
+  double best = INFINITY;
+  for (int pass = 0; pass < kLoadPasses; ++pass) {
+    Clock::time_point start = Clock::now();
+    load();
+    best = std::min(
+        best, std::chrono::duration<double>(Clock::now() - start).count());
+  }
+  return best * 1000;
+}
+
+/**
+ * @brief Разбор файла, загрузка из кэша и чтение отображённого кэша.
+ */
+void benchmarkLoading(const char *file) {
+  const std::string directory = "benchmark_cache";
+  s21::MeshCache cache(directory);
+  s21::Model::Data data;
+  s21::Model::parseFile(file, data);
+  if (!cache.store(file, data)) {
+    std::printf("  cannot write the mesh cache to %s\n", directory.c_str());
+    return;
+  }
+  const std::string path = cache.pathFor(file);
+
+  double parse = bestLoadTime([&] { s21::Model::parseFile(file, data); });
+  double load = bestLoadTime([&] { cache.load(file, data); });
+  volatile char sink = 0;
+  std::size_t size = 0;
+  double map = bestLoadTime([&] {
+    s21::MappedFile mapped(path.c_str());
+    size = mapped.size();
+    for (const char *p = mapped.begin(); p < mapped.end(); p += 4096)
+      sink = *p;
+  });
+  std::printf("%s, loading (%.1f MB cache):\n", file, size / 1048576.0);
+  std::printf("  parse .obj            %8.2f ms\n", parse);
+  std::printf("  mesh cache load       %8.2f ms\n", load);
+  std::printf("  map cache, no copy    %8.2f ms\n", map);
+  std::remove(path.c_str());
+  std::remove(directory.c_str());
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  const char *file = argc > 1 ? argv[1] : "obj_models/Wolf_obj.obj";
+  s21::Model::Data data;
+  if (!s21::Model::parseFile(file, data)) {
+    std::fprintf(stderr, "Cannot open %s\n", file);
+    return 1;
+  }
+
+  const char *const kinds[] = {"", ", smoothed", ", smoothed, gradient"};
+  for (int kind = 0; kind < 3; ++kind) {
+    std::vector<Frame> frames = renderFrames(data, kind == 0 ? 1 : 2);
+    if (kind == 2) addGradient(frames);
+    std::printf("%s, %d frames %dx%d%s:\n", file, kFrames, kWidth, kHeight,
+                kinds[kind]);
+    benchmarkGiflib(frames);
+    benchmarkOctree(frames, false, s21::ColorQuantizer::Dither::kNone,
+                    "octree per frame");
+    benchmarkOctree(frames, true, s21::ColorQuantizer::Dither::kNone,
+                    "octree shared");
+    benchmarkOctree(frames, true, s21::ColorQuantizer::Dither::kOrdered,
+                    "octree shared+dither");
+    benchmarkLzw(frames);
+  }
+  benchmarkLoading(file);
+  return 0;
+}
@@ -1,7 +1,43 @@
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <zlib.h>
+#ifdef S21_WITH_ZSTD
+#include <zstd.h>
+#endif
+#ifdef QT_GUI_LIB
+#include <QBuffer>
+#include <QImage>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "../Viewer/affine.h"
+#include "../Viewer/bounded_queue.h"
+#include "../Viewer/color_quantizer.h"
+#include "../Viewer/decompressor.h"
+#include "../Viewer/frame_delta.h"
+#include "../Viewer/mesh_cache.h"
 #include "../Viewer/model.h"
+#include "../Viewer/rasterizer.h"
+#include "../Viewer/render_settings.h"
+#include "../Viewer/transform_kernels.h"
+#ifdef QT_GUI_LIB
+#include "../Viewer/QtGifImage/src/gifimage/qgifimage.h"
+#include "../Viewer/gif_recorder.h"
+#endif
+#include "../Viewer/QtGifImage/src/3rdParty/giflib/gif_lib.h"
+#include "../Viewer/QtGifImage/src/gifimage/gifstream.h"
 
 TEST(ParserTest, Test1) {
   s21::Model &model = s21::Model::getInstance();
@@ -81,6 +117,368 @@ TEST(ParserTest, Test7) {
   model.releaseResources();
 }
 
+TEST(ParserTest, NumberFormats) {
+  const char *file_name = "number_formats.obj";
+  std::ofstream(file_name) << "# comment\r\n"
+                           << "v 1e2 -2.5E-1 +3\r\n"
+                           << "v .5 -0.000001 12345.6789\r\n"
+                           << "v 0 0 0\r\n"
+                           << "f 1 2 3\r\n";
+  s21::Model &model = s21::Model::getInstance();
+  model.coreParser(file_name);
+  ASSERT_EQ(3u, model.viewer.count_of_vertexes);
+  ASSERT_EQ(1u, model.viewer.count_of_polygons);
+  ASSERT_FLOAT_EQ(100.0, model.viewer.vertexes.x(0));
+  ASSERT_FLOAT_EQ(-0.25, model.viewer.vertexes.y(0));
+  ASSERT_FLOAT_EQ(3.0, model.viewer.vertexes.z(0));
+  ASSERT_FLOAT_EQ(0.5, model.viewer.vertexes.x(1));
+  ASSERT_FLOAT_EQ(-0.000001, model.viewer.vertexes.y(1));
+  ASSERT_FLOAT_EQ(12345.6789, model.viewer.vertexes.z(1));
+  model.releaseResources();
+  std::remove(file_name);
+}
+
+TEST(ParserTest, FaceFormats) {
+  const char *file_name = "face_formats.obj";
+  std::ofstream(file_name) << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+                           << "f 1/1/1 2/2/2 3/3/3 4/4/4\n"
+                           << "f 1//1 2//2 3//3\n"
+                           << "f -4 -3 -1\n";
+  s21::Model &model = s21::Model::getInstance();
+  model.coreParser(file_name);
+  ASSERT_EQ(3u, model.viewer.count_of_polygons);
+  unsigned int expect_counts[3] = {4, 3, 3};
+  unsigned int expect_indexes[3][4] = {{0, 1, 2, 3}, {0, 1, 2}, {0, 1, 3}};
+  const s21::Model::Faces &faces = model.viewer.faces;
+  ASSERT_EQ(faces.offsets.size(), faces.size() + 1u);
+  for (uint32_t i = 0; i < faces.size(); i++) {
+    ASSERT_EQ(expect_counts[i], faces.count(i));
+    for (uint32_t j = 0; j < faces.count(i); j++)
+      ASSERT_EQ(expect_indexes[i][j], faces.begin(i)[j]);
+  }
+  model.releaseResources();
+  std::remove(file_name);
+}
+
+// Тест на загрузку из кэша и отказ от кэша после изменения файла
+TEST(ParserTest, MeshCache) {
+  const char *file_name = "mesh_cache.obj";
+  const std::string directory = "mesh_cache_test";
+  std::ofstream(file_name) << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+                           << "f 1 2 3 4\nf 1 3 4\n";
+  s21::Model::Data parsed, cached;
+  ASSERT_TRUE(s21::Model::parseFile(file_name, parsed));
+  s21::MeshCache cache(directory);
+  ASSERT_FALSE(cache.isCurrent(file_name));
+  // Отменённая запись не оставляет кэша
+  std::atomic<bool> cancelled{true};
+  ASSERT_FALSE(cache.store(file_name, parsed, &cancelled));
+  ASSERT_FALSE(cache.isCurrent(file_name));
+  ASSERT_TRUE(cache.store(file_name, parsed));
+  ASSERT_TRUE(cache.isCurrent(file_name));
+  ASSERT_TRUE(s21::Model::loadFile(file_name, cached, 0, directory));
+  ASSERT_EQ(parsed.count_of_vertexes, cached.count_of_vertexes);
+  ASSERT_EQ(parsed.count_of_polygons, cached.count_of_polygons);
+  ASSERT_EQ(parsed.count_of_edges, cached.count_of_edges);
+  for (std::size_t i = 0; i < parsed.vertexes.size(); i++)
+    for (std::size_t c = 0; c < 3; c++)
+      ASSERT_EQ(parsed.vertexes.at(i, c), cached.vertexes.at(i, c));
+  ASSERT_EQ(parsed.faces.indexes, cached.faces.indexes);
+  ASSERT_EQ(parsed.faces.offsets, cached.faces.offsets);
+  ASSERT_EQ(parsed.edges, cached.edges);
+  ASSERT_EQ(parsed.maxX, cached.maxX);
+  ASSERT_EQ(parsed.minY, cached.minY);
+
+  // Загрузка не записывает кэш: его записывает storeCache() после замены
+  // данных модели
+  std::ofstream(file_name, std::ios::app) << "v 2 2 2\n";
+  ASSERT_FALSE(cache.isCurrent(file_name));
+  ASSERT_FALSE(cache.load(file_name, cached));
+  ASSERT_TRUE(s21::Model::loadFile(file_name, cached, 0, directory));
+  ASSERT_EQ(5u, cached.count_of_vertexes);
+  ASSERT_FALSE(cache.isCurrent(file_name));
+  s21::Model &model = s21::Model::getInstance();
+  model.setCacheDirectory(directory);
+  model.replace(std::move(cached));
+  model.storeCache(file_name).wait();
+  model.setCacheDirectory(std::string());
+  model.releaseResources();
+  ASSERT_TRUE(cache.load(file_name, cached));
+  ASSERT_EQ(5u, cached.count_of_vertexes);
+
+  // При загрузке из кэша размер файла берётся из проверки кэша
+  s21::Model::Progress progress;
+  ASSERT_TRUE(
+      s21::Model::loadFile(file_name, cached, 0, directory, &progress));
+  const uint64_t size = std::ifstream(file_name, std::ios::ate).tellg();
+  ASSERT_EQ(size, progress.total);
+  ASSERT_EQ(size, progress.bytes);
+
+  // Последнее число файла кэша — индекс вершины последнего ребра
+  {
+    std::fstream f(cache.pathFor(file_name),
+                   std::ios::in | std::ios::out | std::ios::binary);
+    const uint32_t bad = 5;
+    f.seekp(-static_cast<std::streamoff>(sizeof(bad)), std::ios::end);
+    f.write(reinterpret_cast<const char *>(&bad), sizeof(bad));
+  }
+  ASSERT_FALSE(cache.load(file_name, cached));
+  ASSERT_EQ(5u, cached.count_of_vertexes);
+  std::remove(cache.pathFor(file_name).c_str());
+  std::remove(directory.c_str());
+  std::remove(file_name);
+}
+
+// Тест на удаление давно не использовавшихся файлов кэша сверх предела
+TEST(ParserTest, MeshCacheLimit) {
+  const std::string directory = "mesh_cache_limit_test";
+  const char *names[] = {"mesh_cache_a.obj", "mesh_cache_b.obj",
+                         "mesh_cache_c.obj"};
+  for (const char *name : names)
+    std::ofstream(name) << "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 3\n";
+  s21::Model::Data data;
+  ASSERT_TRUE(s21::Model::parseFile(names[0], data));
+  s21::MeshCache unlimited(directory);
+  ASSERT_TRUE(unlimited.store(names[0], data));
+  const uint64_t size =
+      std::ifstream(unlimited.pathFor(names[0]), std::ios::ate).tellg();
+  ASSERT_GT(size, 0u);
+
+  // Предел вмещает два файла; b использовался раньше a
+  s21::MeshCache cache(directory, 2 * size);
+  ASSERT_TRUE(cache.store(names[1], data));
+  auto age = [&](const char *name, long seconds) {
+    const struct timespec times[2] = {{seconds, 0}, {seconds, 0}};
+    ASSERT_EQ(0, utimensat(AT_FDCWD, cache.pathFor(name).c_str(), times, 0));
+  };
+  age(names[0], 1000);
+  age(names[1], 2000);
+  // Загрузка из кэша делает a последним использованным
+  s21::Model::Data loaded;
+  ASSERT_TRUE(cache.load(names[0], loaded));
+  ASSERT_TRUE(cache.store(names[2], data));
+  ASSERT_TRUE(cache.isCurrent(names[0]));
+  ASSERT_FALSE(cache.isCurrent(names[1]));
+  ASSERT_TRUE(cache.isCurrent(names[2]));
+
+  // Только что записанный файл остаётся, даже если превышает предел
+  s21::MeshCache tiny(directory, 1);
+  ASSERT_TRUE(tiny.store(names[1], data));
+  ASSERT_FALSE(cache.isCurrent(names[0]));
+  ASSERT_TRUE(cache.isCurrent(names[1]));
+  ASSERT_FALSE(cache.isCurrent(names[2]));
+
+  std::remove(cache.pathFor(names[1]).c_str());
+  std::remove(directory.c_str());
+  for (const char *name : names) std::remove(name);
+}
+
+// Тест на ход загрузки и её отмену
+TEST(ParserTest, ProgressAndCancel) {
+  const char *file_name = "progress.obj";
+  {
+    std::ofstream f(file_name);
+    for (int i = 0; i < 100000; ++i)
+      f << "v " << i << " 0.5 -0.25\nf " << i + 1 << ' ' << i + 1 << ' '
+        << i + 1 << '\n';
+  }
+  s21::Model::Data data;
+  s21::Model::Progress progress;
+  ASSERT_TRUE(s21::Model::parseFile(file_name, data, 4, &progress));
+  ASSERT_GT(progress.total, 0u);
+  ASSERT_EQ(progress.total, progress.bytes);
+  ASSERT_EQ(100000u, progress.vertexes);
+  ASSERT_EQ(100000u, progress.polygons);
+  ASSERT_EQ(100000u, data.count_of_vertexes);
+
+  // Предпросмотр получает все вершины и границы модели
+  s21::Model::Progress preview;
+  preview.publish = true;
+  ASSERT_TRUE(s21::Model::parseFile(file_name, data, 4, &preview));
+  ASSERT_EQ(100000u, preview.preview.vertexes.size());
+  ASSERT_EQ(data.minX, preview.preview.minX);
+  ASSERT_EQ(data.maxX, preview.preview.maxX);
+  s21::Model::Data shown;
+  ASSERT_TRUE(s21::Model::copyPreview(preview, shown));
+  ASSERT_FALSE(s21::Model::copyPreview(preview, shown));
+  ASSERT_EQ(100000u, shown.count_of_vertexes);
+  ASSERT_EQ(data.maxZ, shown.maxZ);
+  ASSERT_EQ(s21::Model::centering(data).m[0][0], shown.matrix.m[0][0]);
+
+  s21::Model::Progress cancelled;
+  cancelled.cancelled = true;
+  ASSERT_FALSE(s21::Model::parseFile(file_name, data, 4, &cancelled));
+  ASSERT_EQ(0u, data.count_of_vertexes);
+  ASSERT_TRUE(data.faces.indexes.empty());
+  std::remove(file_name);
+}
+
+// Тест на потоковый разбор файла gzip из нескольких сжатых потоков
+TEST(ParserTest, GzipStream) {
+  const char *plain_name = "stream.obj", *gzip_name = "stream.obj.gz";
+  std::string text;
+  for (int i = 0; i < 500000; ++i)
+    text += "v " + std::to_string(i) + " 1.5 -2\nf -1 " +
+            std::to_string(i / 2 + 1) + " 1\n";
+  std::ofstream(plain_name) << text;
+  // Граница сжатых потоков посреди строки
+  const std::size_t half = text.size() / 2 + 3;
+  for (int part = 0; part < 2; ++part) {
+    gzFile gzip = gzopen(gzip_name, part == 0 ? "wb1" : "ab1");
+    ASSERT_NE(nullptr, gzip);
+    const char *begin = text.data() + (part == 0 ? 0 : half);
+    std::size_t size = part == 0 ? half : text.size() - half;
+    ASSERT_EQ(static_cast<int>(size),
+              gzwrite(gzip, begin, static_cast<unsigned>(size)));
+    gzclose(gzip);
+  }
+
+  s21::Model::Data plain, packed;
+  s21::Model::Progress progress;
+  ASSERT_TRUE(s21::Model::parseFile(plain_name, plain, 3));
+  ASSERT_TRUE(s21::Model::parseFile(gzip_name, packed, 3, &progress));
+  ASSERT_EQ(500000u, packed.count_of_vertexes);
+  ASSERT_EQ(plain.faces.indexes, packed.faces.indexes);
+  ASSERT_EQ(plain.faces.offsets, packed.faces.offsets);
+  ASSERT_EQ(plain.edges, packed.edges);
+  ASSERT_EQ(plain.maxX, packed.maxX);
+  ASSERT_EQ(progress.total, progress.bytes);
+  ASSERT_EQ(500000u, progress.polygons);
+
+  // Обрезанный файл не загружается
+  std::ifstream in(gzip_name, std::ios::binary);
+  std::string compressed((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+  std::ofstream(gzip_name, std::ios::binary)
+      << compressed.substr(0, compressed.size() - 100);
+  ASSERT_FALSE(s21::Model::parseFile(gzip_name, packed));
+  ASSERT_EQ(0u, packed.count_of_vertexes);
+  std::remove(plain_name);
+  std::remove(gzip_name);
+}
+
+#ifdef S21_WITH_ZSTD
+// Тест на потоковый разбор файла из нескольких сжатых потоков zstd
+TEST(ParserTest, ZstdStream) {
+  const char *plain_name = "stream.obj", *zstd_name = "stream.obj.zst";
+  std::string text;
+  for (int i = 0; i < 500000; ++i)
+    text += "v " + std::to_string(i) + " 1.5 -2\nf -1 " +
+            std::to_string(i / 2 + 1) + " 1\n";
+  std::ofstream(plain_name) << text;
+  // Граница сжатых потоков посреди строки
+  const std::size_t half = text.size() / 2 + 3;
+  std::string compressed;
+  for (int part = 0; part < 2; ++part) {
+    const char *begin = text.data() + (part == 0 ? 0 : half);
+    std::size_t size = part == 0 ? half : text.size() - half;
+    std::string frame(ZSTD_compressBound(size), '\0');
+    std::size_t written =
+        ZSTD_compress(&frame[0], frame.size(), begin, size, 1);
+    ASSERT_FALSE(ZSTD_isError(written));
+    compressed.append(frame, 0, written);
+  }
+  std::ofstream(zstd_name, std::ios::binary) << compressed;
+  ASSERT_EQ(s21::Decompressor::Format::kZstd,
+            s21::Decompressor::detect(zstd_name));
+
+  s21::Model::Data plain, packed;
+  s21::Model::Progress progress;
+  ASSERT_TRUE(s21::Model::parseFile(plain_name, plain, 3));
+  ASSERT_TRUE(s21::Model::parseFile(zstd_name, packed, 3, &progress));
+  ASSERT_EQ(500000u, packed.count_of_vertexes);
+  ASSERT_EQ(plain.faces.indexes, packed.faces.indexes);
+  ASSERT_EQ(plain.faces.offsets, packed.faces.offsets);
+  ASSERT_EQ(plain.edges, packed.edges);
+  ASSERT_EQ(plain.maxX, packed.maxX);
+  ASSERT_EQ(progress.total, progress.bytes);
+  ASSERT_EQ(500000u, progress.polygons);
+
+  // Обрезанный файл не загружается
+  std::ofstream(zstd_name, std::ios::binary)
+      << compressed.substr(0, compressed.size() - 100);
+  ASSERT_FALSE(s21::Model::parseFile(zstd_name, packed));
+  ASSERT_EQ(0u, packed.count_of_vertexes);
+  std::remove(plain_name);
+  std::remove(zstd_name);
+}
+#endif
+
+// Тест на удаление повторяющихся рёбер
+TEST(ParserTest, UniqueEdges) {
+  s21::Model &model = s21::Model::getInstance();
+  model.coreParser("obj_models/cube.obj");
+  // 12 треугольников: 12 рёбер куба и 6 диагоналей граней
+  ASSERT_EQ(18u, model.viewer.count_of_edges);
+  const std::vector<uint32_t> &edges = model.viewer.edges;
+  ASSERT_EQ(edges.size(), model.viewer.count_of_edges * 2u);
+  for (std::size_t e = 0; e < edges.size(); e += 2) {
+    ASSERT_LT(edges[e], edges[e + 1]);
+    ASSERT_LT(edges[e + 1], model.viewer.count_of_vertexes);
+    if (e > 0) {
+      ASSERT_TRUE(edges[e - 2] < edges[e] ||
+                  (edges[e - 2] == edges[e] && edges[e - 1] < edges[e + 1]));
+    }
+  }
+  model.releaseResources();
+  ASSERT_TRUE(model.viewer.edges.empty());
+}
+
+TEST(ParserTest, ParallelChunks) {
+  const char *file_name = "parallel_chunks.obj";
+  {
+    std::ofstream f(file_name);
+    for (int i = 0; i < 3000; i++) {
+      f << "v " << i << " " << -i * 0.5 << " " << i % 7 << "\n";
+      if (i % 3 == 2) f << "f -3/1 -2/2 -1/3\n";
+      if (i % 5 == 4) f << "f 1 " << i + 1 << "//4 " << i << "\n";
+    }
+  }
+  s21::Model &model = s21::Model::getInstance();
+  model.setParserThreads(1);
+  model.coreParser(file_name);
+  s21::Model::Data expect = model.viewer;
+  model.setParserThreads(7);
+  model.coreParser(file_name);
+  model.setParserThreads(0);
+
+  ASSERT_EQ(expect.count_of_vertexes, model.viewer.count_of_vertexes);
+  ASSERT_EQ(expect.count_of_polygons, model.viewer.count_of_polygons);
+  ASSERT_EQ(expect.faces.indexes, model.viewer.faces.indexes);
+  ASSERT_EQ(expect.faces.offsets, model.viewer.faces.offsets);
+  for (std::size_t i = 0; i < expect.vertexes.size(); i++)
+    ASSERT_EQ(expect.vertexes.y(i), model.viewer.vertexes.y(i));
+  ASSERT_DOUBLE_EQ(expect.minY, model.viewer.minY);
+  ASSERT_DOUBLE_EQ(expect.maxX, model.viewer.maxX);
+  ASSERT_EQ(2u, model.viewer.faces.begin(0)[2]);
+  model.releaseResources();
+  std::remove(file_name);
+}
+
+TEST(VertexBufferTest, Layouts) {
+  s21::VertexBuffer<float, s21::VertexLayout::kPacked> packed;
+  s21::VertexBuffer<double, s21::VertexLayout::kSoA> soa;
+  for (int i = 0; i < 4; i++) {
+    packed.push_back(i, i + 10, i + 20);
+    soa.push_back(i, i + 10, i + 20);
+  }
+  ASSERT_EQ(4u, packed.size());
+  ASSERT_EQ(4u, soa.size());
+  for (std::size_t i = 0; i < 4; i++) {
+    ASSERT_FLOAT_EQ(packed.data()[i * packed.stride() + 1], soa.data(1)[i]);
+    ASSERT_DOUBLE_EQ(soa.z(i), i + 20.0);
+  }
+  packed.clear();
+  ASSERT_TRUE(packed.empty());
+}
+
+// Вершины модели с применённой матрицей модели, как их преобразует отрисовка
+static s21::Model::Vertexes transformed(const s21::Model &model) {
+  s21::Model::Vertexes result = model.viewer.vertexes;
+  s21::kernels::transform(result.data(), result.size(), model.viewer.matrix);
+  return result;
+}
+
 TEST(AffineTest, AffineTransform) {
   s21::Model &model = s21::Model::getInstance();
   const char *file_name = "obj_models/no_File.obj";
@@ -92,6 +490,722 @@ TEST(AffineTest, AffineTransform) {
   model.releaseResources();
 }
 
+// Тест на совпадение свёрнутой матрицы с последовательными операциями
+TEST(AffineTest, ComposedMatchesSequential) {
+  s21::Model &model = s21::Model::getInstance();
+  const char *file_name = "obj_models/cube.obj";
+  double transform_data[3][3] = {
+      {2.0, 1.0, 3.0}, {0.5, 1.0, -0.2}, {1.5, 0.8, 2.0}};
+  s21::Affine affine;
+
+  model.coreParser(file_name);
+  affine.movingX(transform_data[0][0]);
+  affine.movingY(transform_data[0][1]);
+  affine.movingZ(transform_data[0][2]);
+  affine.rotationX(transform_data[1][0]);
+  affine.rotationY(transform_data[1][1]);
+  affine.rotationZ(transform_data[1][2]);
+  affine.scaling(transform_data[2][0]);
+  s21::Model::Vertexes expect = transformed(model);
+
+  model.coreParser(file_name);
+  affine.affineTransform(transform_data);
+  s21::Model::Vertexes composed = transformed(model);
+  for (std::size_t i = 0; i < expect.size(); ++i)
+    for (std::size_t c = 0; c < 3; ++c)
+      ASSERT_NEAR(expect.at(i, c), composed.at(i, c), 1e-5);
+  model.releaseResources();
+}
+
+// Тест на неизменность загруженной геометрии при преобразованиях
+TEST(AffineTest, GeometryIsImmutable) {
+  s21::Model &model = s21::Model::getInstance();
+  model.coreParser("obj_models/cube.obj");
+  s21::Model::Vertexes source = model.viewer.vertexes;
+  s21::Affine affine;
+  for (int i = 0; i < 100; ++i) {
+    affine.scaling(1.1);
+    affine.rotationY(0.1);
+  }
+  for (std::size_t i = 0; i < source.size(); ++i)
+    for (std::size_t c = 0; c < 3; ++c)
+      ASSERT_EQ(source.at(i, c), model.viewer.vertexes.at(i, c));
+  model.releaseResources();
+}
+
+// Тест векторизованных ядер на всех наборах инструкций процессора
+TEST(KernelsTest, AllIsaMatchReference) {
+  const std::size_t count = 1003;
+  std::vector<float> source(count * 3);
+  for (std::size_t i = 0; i < source.size(); i++)
+    source[i] = static_cast<float>((i * 7919 % 2003) / 1001.0 - 1.0);
+  s21::TransformMatrix matrix = s21::TransformMatrix::scaling(1.7) *
+                                s21::TransformMatrix::rotationZ(0.3) *
+                                s21::TransformMatrix::rotationX(-1.1) *
+                                s21::TransformMatrix::translation(1, -2, 3);
+
+  for (int isa = 0; isa <= static_cast<int>(s21::kernels::bestIsa()); isa++) {
+    s21::kernels::setIsa(static_cast<s21::kernels::Isa>(isa));
+    std::vector<float> full = source;
+    s21::kernels::transform(full.data(), count, matrix);
+    for (std::size_t i = 0; i < count; i++) {
+      double x = source[i * 3], y = source[i * 3 + 1], z = source[i * 3 + 2];
+      matrix.apply(x, y, z);
+      double expect[3] = {x, y, z};
+      for (std::size_t c = 0; c < 3; c++)
+        ASSERT_NEAR(expect[c], full[i * 3 + c], 1e-5);
+    }
+  }
+  s21::kernels::setIsa(s21::kernels::bestIsa());
+}
+
+// Тест разбора настроек отображения
+TEST(RenderSettingsTest, Parse) {
+  s21::RenderSettings render;
+  ASSERT_EQ(s21::RenderSettings::PointShape::kNone, render.vertex_display);
+  render.set("projection", "Central");
+  render.set("lineType", "Dashed");
+  render.set("lineColor", "Green");
+  render.set("lineWidth", "3");
+  render.set("vertexDisplay", "Square");
+  render.set("vertexSize", "");
+  render.set("backgroundColor", "Unknown");
+  render.set("unknownKey", "Red");
+  ASSERT_EQ(s21::RenderSettings::Projection::kCentral, render.projection);
+  ASSERT_EQ(s21::RenderSettings::LineType::kDashed, render.line_type);
+  ASSERT_EQ(0.0f, render.line_color.r);
+  ASSERT_EQ(1.0f, render.line_color.g);
+  ASSERT_EQ(3.0f, render.line_width);
+  ASSERT_EQ(s21::RenderSettings::PointShape::kSquare, render.vertex_display);
+  ASSERT_EQ(1.0f, render.vertex_size);
+  ASSERT_EQ(0.0f, render.background_color.r);
+  ASSERT_EQ(1.0f, render.background_color.a);
+}
+
+// Тест программной отрисовки отрезка в обеих проекциях
+TEST(RasterizerTest, ProjectsLikePaintGL) {
+  s21::Model::Data data;
+  data.vertexes.push_back(-1, 0, 0);
+  data.vertexes.push_back(1, 0, 0);
+  data.vertexes.push_back(0, 0, 7);
+  data.edges = {0, 1};
+  s21::RenderSettings render;
+  render.line_color = {1, 0, 0, 1};
+  render.vertex_display = s21::RenderSettings::PointShape::kSquare;
+  render.vertex_color = {0, 1, 0, 1};
+  const uint32_t background = 0xFF000000, red = 0xFFFF0000;
+
+  s21::Rasterizer rasterizer(64, 64);
+  rasterizer.render(data, render, s21::TransformMatrix::identity(),
+                    s21::TransformMatrix::identity());
+  const uint32_t *row = rasterizer.pixels() + 32 * 64;
+  ASSERT_EQ(background, row[10]);
+  for (int x = 17; x < 47; ++x) ASSERT_EQ(red, row[x]);
+  ASSERT_EQ(background, row[50]);
+  // Вершина в плоскости камеры отсекается ближней плоскостью
+  ASSERT_EQ(0xFF00FF00u, row[16]);
+  ASSERT_EQ(background, rasterizer.pixels()[0]);
+
+  render.projection = s21::RenderSettings::Projection::kCentral;
+  render.vertex_display = s21::RenderSettings::PointShape::kNone;
+  rasterizer.render(data, render, s21::TransformMatrix::identity(),
+                    s21::TransformMatrix::identity());
+  // x = 2.5 * 1 / 7 в нормализованных координатах
+  ASSERT_EQ(red, row[43]);
+  ASSERT_EQ(background, row[45]);
+  ASSERT_EQ(red, row[20]);
+  ASSERT_EQ(background, row[19]);
+}
+
+// Тест на толщину, пунктир и независимость результата от числа полос
+TEST(RasterizerTest, StyledLinesAreTileIndependent) {
+  s21::Model::Data data;
+  data.vertexes.push_back(-1.5, 0, 0);
+  data.vertexes.push_back(1.5, 0, 0);
+  data.vertexes.push_back(0, -1.5, 0);
+  data.vertexes.push_back(0, 1.5, 0);
+  data.edges = {0, 1, 2, 3};
+  s21::RenderSettings render;
+  render.line_type = s21::RenderSettings::LineType::kDashed;
+  render.line_width = 3;
+  render.vertex_display = s21::RenderSettings::PointShape::kCircle;
+  render.vertex_size = 6;
+  const s21::TransformMatrix view =
+      s21::Rasterizer::sceneRotation(20, 30, 0);
+
+  s21::Rasterizer single(100, 100), tiled(100, 100);
+  single.setThreads(1);
+  tiled.setThreads(7);
+  single.render(data, render, s21::TransformMatrix::identity(),
+                s21::TransformMatrix::identity());
+  tiled.render(data, render, s21::TransformMatrix::identity(),
+               s21::TransformMatrix::identity());
+  ASSERT_TRUE(std::equal(single.pixels(), single.pixels() + 100 * 100,
+                         tiled.pixels()));
+
+  // Горизонтальное ребро от x = 12.5: 8 пикселей штриха, 8 пропуска,
+  // толщина 3 пикселя по вертикали
+  const uint32_t white = 0xFFFFFFFF, black = 0xFF000000;
+  const uint32_t *pixels = single.pixels();
+  for (int y = 49; y <= 51; ++y) {
+    ASSERT_EQ(white, pixels[y * 100 + 16]);
+    ASSERT_EQ(black, pixels[y * 100 + 24]);
+  }
+  ASSERT_EQ(black, pixels[48 * 100 + 16]);
+  ASSERT_EQ(black, pixels[52 * 100 + 16]);
+  // Круглая вершина диаметром 6: угол описанного квадрата не закрашен
+  ASSERT_EQ(white, pixels[50 * 100 + 12]);
+  ASSERT_EQ(black, pixels[47 * 100 + 9]);
+
+  single.render(data, render, view, s21::TransformMatrix::identity(), true);
+  tiled.render(data, render, view, s21::TransformMatrix::identity(), true);
+  ASSERT_TRUE(std::equal(single.pixels(), single.pixels() + 100 * 100,
+                         tiled.pixels()));
+}
+
+// Тест на передачу элементов через очередь ограниченного размера
+TEST(BoundedQueueTest, KeepsOrderAndCloses) {
+  s21::BoundedQueue<int> queue(2);
+  std::thread producer([&queue] {
+    for (int i = 0; i < 100; ++i) ASSERT_TRUE(queue.push(i));
+    queue.close();
+  });
+  int item = -1;
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(queue.pop(item));
+    ASSERT_EQ(i, item);
+  }
+  ASSERT_FALSE(queue.pop(item));
+  producer.join();
+  ASSERT_FALSE(queue.push(0));
+}
+
+// Тест на добавление в очередь без ожидания
+TEST(BoundedQueueTest, TryPushDoesNotWait) {
+  s21::BoundedQueue<int> queue(2);
+  ASSERT_TRUE(queue.tryPush(0));
+  ASSERT_TRUE(queue.tryPush(1));
+  ASSERT_FALSE(queue.tryPush(2));
+  int item = -1;
+  ASSERT_TRUE(queue.pop(item));
+  ASSERT_EQ(0, item);
+  ASSERT_TRUE(queue.tryPush(3));
+  queue.close();
+  ASSERT_FALSE(queue.tryPush(4));
+  ASSERT_TRUE(queue.pop(item));
+  ASSERT_EQ(1, item);
+  ASSERT_TRUE(queue.pop(item));
+  ASSERT_EQ(3, item);
+  ASSERT_FALSE(queue.pop(item));
+}
+
+// Тест на построение палитры и перевод в индексы
+TEST(ColorQuantizerTest, PaletteAndMapping) {
+  // Несколько цветов сохраняются без потерь
+  std::vector<uint32_t> few(64 * 64, 0xFF101030u);
+  for (int i = 0; i < 64; ++i) few[i * 64 + i] = 0xFFFFFF00u;
+  few[5] = 0xFFFF0000u;
+  s21::ColorQuantizer quantizer;
+  std::vector<uint8_t> indexes(few.size());
+  quantizer.map(few.data(), 64, 64, 64, indexes.data(), 64);
+  ASSERT_EQ(3u, quantizer.palette().size());
+  for (std::size_t i = 0; i < few.size(); ++i)
+    ASSERT_EQ(few[i], quantizer.palette()[indexes[i]]);
+
+  // Градиент сводится к 256 цветам с небольшой ошибкой
+  std::vector<uint32_t> gradient(256 * 256);
+  for (uint32_t y = 0; y < 256; ++y)
+    for (uint32_t x = 0; x < 256; ++x)
+      gradient[y * 256 + x] = 0xFF000000u | x << 16 | y << 8 | (x + y) / 2;
+  quantizer.buildPalette(gradient.data(), 256, 256, 256);
+  ASSERT_LE(quantizer.palette().size(), 256u);
+  indexes.resize(gradient.size());
+  quantizer.map(gradient.data(), 256, 256, 256, indexes.data(), 256);
+  for (std::size_t i = 0; i < gradient.size(); ++i)
+    for (int shift = 0; shift <= 16; shift += 8)
+      ASSERT_NEAR(gradient[i] >> shift & 0xFF,
+                  quantizer.palette()[indexes[i]] >> shift & 0xFF, 24);
+
+  // Дизеринг не искажает чистые цвета палитры
+  s21::ColorQuantizer dithered(256, s21::ColorQuantizer::Dither::kOrdered);
+  std::vector<uint32_t> pure = {0xFF000000u, 0xFFFFFFFFu, 0xFF000000u,
+                                0xFFFFFFFFu};
+  dithered.map(pure.data(), 4, 1, 4, indexes.data(), 4);
+  for (std::size_t i = 0; i < pure.size(); ++i)
+    ASSERT_EQ(pure[i], dithered.palette()[indexes[i]]);
+}
+
+// Тест на выбор прозрачного цвета, отсутствующего в палитре
+TEST(ColorQuantizerTest, UnusedColor) {
+  s21::ColorQuantizer quantizer;
+  ASSERT_EQ(0xFF000000u, quantizer.unusedColor());
+  std::vector<uint32_t> pixels = {0xFF000000u, 0xFF000001u, 0xFF000003u,
+                                  0xFFFFFFFFu};
+  quantizer.buildPalette(pixels.data(), 4, 1, 4);
+  ASSERT_EQ(4u, quantizer.palette().size());
+  ASSERT_EQ(0xFF000002u, quantizer.unusedColor());
+}
+
+// Тест на поиск изменившейся области и прозрачные неизменившиеся пиксели
+TEST(FrameDeltaTest, ChangedRectAndTransparency) {
+  std::vector<uint32_t> previous(40 * 30, 0xFF202020u);
+  std::vector<uint32_t> current = previous;
+  s21::FrameRect rect = s21::changedRect(current.data(), previous.data(), 40,
+                                         30, 40);
+  ASSERT_TRUE(rect.empty());
+
+  current[5 * 40 + 7] = 0xFFFF0000u;
+  current[12 * 40 + 3] = 0xFF00FF00u;
+  current[9 * 40 + 31] = 0xFF0000FFu;
+  rect = s21::changedRect(current.data(), previous.data(), 40, 30, 40);
+  ASSERT_EQ(3, rect.x);
+  ASSERT_EQ(5, rect.y);
+  ASSERT_EQ(29, rect.width);
+  ASSERT_EQ(8, rect.height);
+
+  s21::ColorQuantizer quantizer(255);
+  std::vector<uint8_t> indexes(rect.width * rect.height);
+  const std::size_t offset = rect.y * 40 + rect.x;
+  quantizer.map(current.data() + offset, rect.width, rect.height, 40,
+                indexes.data(), rect.width, previous.data() + offset, 255);
+  for (int y = 0; y < rect.height; ++y)
+    for (int x = 0; x < rect.width; ++x) {
+      uint32_t pixel = current[offset + y * 40 + x];
+      uint8_t index = indexes[y * rect.width + x];
+      if (pixel == previous[offset + y * 40 + x])
+        ASSERT_EQ(255, index);
+      else
+        ASSERT_EQ(pixel, quantizer.palette()[index]);
+    }
+}
+
+// Тест на выравнивание области кадра под матрицу дизеринга
+TEST(FrameDeltaTest, AlignRect) {
+  s21::FrameRect rect =
+      s21::alignRect(s21::FrameRect{7, 5, 10, 3},
+                     s21::ColorQuantizer::kDitherSize);
+  ASSERT_EQ(4, rect.x);
+  ASSERT_EQ(4, rect.y);
+  ASSERT_EQ(13, rect.width);
+  ASSERT_EQ(4, rect.height);
+  rect = s21::alignRect(s21::FrameRect{8, 0, 2, 2}, 4);
+  ASSERT_EQ(8, rect.x);
+  ASSERT_EQ(2, rect.width);
+  ASSERT_TRUE(s21::alignRect(s21::FrameRect{3, 3, 0, 5}, 4).empty());
+}
+
+// Запись GIF в строку через функцию вывода giflib
+static int writeGif(GifFileType *gif, const GifByteType *data, int size) {
+  static_cast<std::string *>(gif->UserData)
+      ->append(reinterpret_cast<const char *>(data), size);
+  return size;
+}
+
+// Чтение GIF из строки через функцию ввода giflib
+struct GifSource {
+  const std::string &data;  // Содержимое файла.
+  std::size_t offset;       // Прочитано байт.
+};
+static int readGif(GifFileType *gif, GifByteType *data, int size) {
+  GifSource &source = *static_cast<GifSource *>(gif->UserData);
+  std::size_t count = std::min<std::size_t>(
+      size, source.data.size() - source.offset);
+  std::memcpy(data, source.data.data() + source.offset, count);
+  source.offset += count;
+  return static_cast<int>(count);
+}
+
+// Разобранный DGifSlurp файл GIF
+struct GifCloser {
+  void operator()(GifFileType *gif) const { DGifCloseFile(gif); }
+};
+using DecodedGif = std::unique_ptr<GifFileType, GifCloser>;
+
+// Разбор всего файла GIF; nullptr, если файл повреждён
+static DecodedGif decodeGif(const std::string &data) {
+  GifSource source{data, 0};
+  int error = 0;
+  DecodedGif gif(DGifOpen(&source, readGif, &error));
+  if (gif && DGifSlurp(gif.get()) == GIF_ERROR) gif.reset();
+  return gif;
+}
+
+// Тест на восстановление кадров, сжатых LZW-кодировщиком giflib
+TEST(GifTest, LzwRoundTrip) {
+  // Шум занимает все 4096 кодов словаря за несколько строк, так что словарь
+  // сбрасывается много раз; длинные одноцветные полосы проверяют поиск
+  // через LastChild
+  const int width = 320, height = 240;
+  std::vector<GifPixelType> noise(width * height), stripes(width * height);
+  uint32_t seed = 12345;
+  for (std::size_t i = 0; i < noise.size(); ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    noise[i] = static_cast<GifPixelType>(seed >> 24);
+    stripes[i] = static_cast<GifPixelType>(i / 1000 % 3 * 80);
+  }
+  for (const std::vector<GifPixelType> *pixels : {&noise, &stripes}) {
+    std::string data;
+    int error = 0;
+    GifFileType *gif = EGifOpen(&data, writeGif, &error);
+    ASSERT_NE(nullptr, gif);
+    ColorMapObject *colors = GifMakeMapObject(256, nullptr);
+    bool ok =
+        EGifPutScreenDesc(gif, width, height, 8, 0, colors) != GIF_ERROR &&
+        EGifPutImageDesc(gif, 0, 0, width, height, false, nullptr) !=
+            GIF_ERROR;
+    GifFreeMapObject(colors);
+    // EGifPutLine() изменяет строку, поэтому передаётся её копия
+    std::vector<GifPixelType> line(width);
+    for (int y = 0; ok && y < height; ++y) {
+      std::copy_n(pixels->data() + y * width, width, line.data());
+      ok = EGifPutLine(gif, line.data(), width) != GIF_ERROR;
+    }
+    ASSERT_NE(GIF_ERROR, EGifCloseFile(gif));
+    ASSERT_TRUE(ok);
+    // Код занимает не больше 12 бит, поэтому кодов в шуме больше, чем
+    // вмещает словарь
+    if (pixels == &noise) {
+      ASSERT_GT(data.size() * 8 / 12, 2u * 4096);
+    }
+
+    DecodedGif decoded = decodeGif(data);
+    ASSERT_NE(nullptr, decoded);
+    ASSERT_EQ(1, decoded->ImageCount);
+    ASSERT_TRUE(std::equal(pixels->begin(), pixels->end(),
+                           decoded->SavedImages[0].RasterBits));
+  }
+}
+
+// Палитра GIF из count оттенков серого
+static ColorMapObject *grayColors(int count) {
+  ColorMapObject *colors = GifMakeMapObject(count, nullptr);
+  for (int i = 0; i < count; ++i) {
+    GifByteType level = static_cast<GifByteType>(i * 255 / (count - 1));
+    colors->Colors[i] = GifColorType{level, level, level};
+  }
+  return colors;
+}
+
+// Повтор анимации из расширения NETSCAPE2.0; -1, если его нет
+static int loopCount(int count, const ExtensionBlock *blocks) {
+  for (int i = 0; i + 1 < count; ++i)
+    if (blocks[i].Function == APPLICATION_EXT_FUNC_CODE &&
+        blocks[i].ByteCount == 11 &&
+        std::memcmp(blocks[i].Bytes, "NETSCAPE2.0", 11) == 0 &&
+        blocks[i + 1].ByteCount == 3)
+      return blocks[i + 1].Bytes[1] | blocks[i + 1].Bytes[2] << 8;
+  return -1;
+}
+
+// Тест на сборку файла из заголовка и кадров, сжатых в разных потоках
+TEST(GifTest, StreamRoundTrip) {
+  struct Frame {
+    int left, top, width, height, delay;
+    std::vector<GifByteType> pixels;
+    const ColorMapObject *colors;
+  };
+  ColorMapObject *global = grayColors(16), *local = grayColors(2);
+  const int transparent = 15;
+  std::vector<Frame> frames = {
+      // Полный кадр
+      {0, 0, 8, 6, 5, std::vector<GifByteType>(8 * 6), nullptr},
+      // Изменившаяся область со смещением и прозрачными пикселями
+      {4, 2, 3, 2, 5, {15, 3, 15, 7, 15, 1}, nullptr},
+      // Кадр с собственной палитрой из двух цветов: размер кода LZW берётся
+      // из неё, а не из общей палитры
+      {1, 1, 2, 2, 5, {0, 1, 1, 0}, local},
+      // Кадр без изменений: один прозрачный пиксель сохраняет задержку
+      {0, 0, 1, 1, 7, {15}, nullptr}};
+  for (std::size_t i = 0; i < frames[0].pixels.size(); ++i)
+    frames[0].pixels[i] = static_cast<GifByteType>(i % transparent);
+
+  const GifStream::Screen screen = {8, 6, 0, global};
+  std::vector<std::future<std::string>> blocks;
+  for (const Frame &frame : frames)
+    blocks.push_back(std::async(std::launch::async, [&screen, &frame] {
+      GraphicsControlBlock control;
+      control.DisposalMode = DISPOSE_DO_NOT;
+      control.UserInputFlag = false;
+      control.DelayTime = frame.delay;
+      control.TransparentColor = transparent;
+      return GifStream::frame(screen, frame.pixels.data(), frame.width,
+                              frame.left, frame.top, frame.width,
+                              frame.height, control, frame.colors);
+    }));
+  std::string data = GifStream::header(screen, 3);
+  ASSERT_FALSE(data.empty());
+  for (std::future<std::string> &block : blocks) {
+    std::string encoded = block.get();
+    ASSERT_FALSE(encoded.empty());
+    data += encoded;
+  }
+  data += GifStream::Trailer;
+  GifFreeMapObject(global);
+  GifFreeMapObject(local);
+
+  DecodedGif gif = decodeGif(data);
+  ASSERT_NE(nullptr, gif);
+  ASSERT_EQ(8, gif->SWidth);
+  ASSERT_EQ(6, gif->SHeight);
+  ASSERT_EQ(16, gif->SColorMap->ColorCount);
+  ASSERT_EQ(static_cast<int>(frames.size()), gif->ImageCount);
+  const SavedImage &first = gif->SavedImages[0];
+  ASSERT_EQ(3, loopCount(first.ExtensionBlockCount, first.ExtensionBlocks));
+  for (int i = 0; i < gif->ImageCount; ++i) {
+    const Frame &frame = frames[i];
+    const SavedImage &image = gif->SavedImages[i];
+    ASSERT_EQ(frame.left, image.ImageDesc.Left);
+    ASSERT_EQ(frame.top, image.ImageDesc.Top);
+    ASSERT_EQ(frame.width, image.ImageDesc.Width);
+    ASSERT_EQ(frame.height, image.ImageDesc.Height);
+    ASSERT_EQ(frame.colors != nullptr, image.ImageDesc.ColorMap != nullptr);
+    GraphicsControlBlock control;
+    ASSERT_EQ(GIF_OK, DGifSavedExtensionToGCB(gif.get(), i, &control));
+    ASSERT_EQ(DISPOSE_DO_NOT, control.DisposalMode);
+    ASSERT_EQ(transparent, control.TransparentColor);
+    ASSERT_EQ(frame.delay, control.DelayTime);
+    ASSERT_TRUE(std::equal(frame.pixels.begin(), frame.pixels.end(),
+                           image.RasterBits));
+  }
+}
+
+// Тест на файл без кадров: заголовок и конец файла
+TEST(GifTest, EmptyStream) {
+  ColorMapObject *global = grayColors(4);
+  std::string data = GifStream::header(GifStream::Screen{0, 0, 0, global}, 0);
+  GifFreeMapObject(global);
+  ASSERT_FALSE(data.empty());
+  data += GifStream::Trailer;
+  DecodedGif gif = decodeGif(data);
+  ASSERT_NE(nullptr, gif);
+  ASSERT_EQ(0, gif->ImageCount);
+  ASSERT_EQ(4, gif->SColorMap->ColorCount);
+  ASSERT_EQ(0, loopCount(gif->ExtensionBlockCount, gif->ExtensionBlocks));
+}
+
+#ifdef QT_GUI_LIB
+// Кадр в формате QImage::Format_Indexed8 из индексов цветов по строкам
+static QImage indexedImage(int width, int height,
+                           const std::vector<uchar> &pixels,
+                           const QVector<QRgb> &colors) {
+  QImage image(width, height, QImage::Format_Indexed8);
+  image.setColorTable(colors);
+  for (int y = 0; y < height; ++y)
+    std::copy_n(pixels.data() + y * width, width, image.scanLine(y));
+  return image;
+}
+
+// Тест на потоковую запись QGifImage: полный кадр и кадры изменившихся
+// областей со смещением
+TEST(QGifImageTest, StreamRoundTrip) {
+  QVector<QRgb> colors;
+  for (int i = 0; i < 16; ++i) colors.append(qRgb(i * 17, i * 17, i * 17));
+  std::vector<uchar> full(8 * 6);
+  for (std::size_t i = 0; i < full.size(); ++i) full[i] = i % 15;
+  const std::vector<uchar> delta = {15, 3, 15, 7, 15, 1};
+  const QPoint offsets[] = {QPoint(0, 0), QPoint(4, 2), QPoint(1, 3)};
+  const int delays[] = {5, 5, 7};
+
+  QByteArray data;
+  QBuffer buffer(&data);
+  ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+  QGifImage gif;
+  gif.setGlobalColorTable(colors);
+  gif.setDefaultTransparentColor(QColor(colors.last()));
+  gif.setDefaultDelay(50);
+  ASSERT_TRUE(gif.open(&buffer));
+  ASSERT_TRUE(gif.writeFrame(indexedImage(8, 6, full, colors), offsets[0]));
+  ASSERT_TRUE(gif.writeFrame(indexedImage(3, 2, delta, colors), offsets[1]));
+  ASSERT_TRUE(
+      gif.writeFrame(indexedImage(3, 2, delta, colors), offsets[2], 70));
+  ASSERT_TRUE(gif.close());
+  ASSERT_FALSE(gif.isOpen());
+
+  DecodedGif decoded = decodeGif(data.toStdString());
+  ASSERT_NE(nullptr, decoded);
+  ASSERT_EQ(8, decoded->SWidth);
+  ASSERT_EQ(6, decoded->SHeight);
+  ASSERT_EQ(3, decoded->ImageCount);
+  for (int i = 0; i < decoded->ImageCount; ++i) {
+    const std::vector<uchar> &pixels = i == 0 ? full : delta;
+    const SavedImage &image = decoded->SavedImages[i];
+    ASSERT_EQ(offsets[i].x(), image.ImageDesc.Left);
+    ASSERT_EQ(offsets[i].y(), image.ImageDesc.Top);
+    ASSERT_EQ(i == 0 ? 8 : 3, image.ImageDesc.Width);
+    ASSERT_EQ(i == 0 ? 6 : 2, image.ImageDesc.Height);
+    ASSERT_EQ(nullptr, image.ImageDesc.ColorMap);
+    GraphicsControlBlock control;
+    ASSERT_EQ(GIF_OK, DGifSavedExtensionToGCB(decoded.get(), i, &control));
+    ASSERT_EQ(DISPOSE_DO_NOT, control.DisposalMode);
+    ASSERT_EQ(15, control.TransparentColor);
+    ASSERT_EQ(delays[i], control.DelayTime);
+    ASSERT_TRUE(
+        std::equal(pixels.begin(), pixels.end(), image.RasterBits));
+  }
+
+  // Записанный файл читает и сам QGifImage
+  QBuffer input(&data);
+  ASSERT_TRUE(input.open(QIODevice::ReadOnly));
+  QGifImage loaded;
+  ASSERT_TRUE(loaded.load(&input));
+  ASSERT_EQ(3, loaded.frameCount());
+  ASSERT_EQ(offsets[1], loaded.frameOffset(1));
+  ASSERT_EQ(70, loaded.frameDelay(2));
+}
+
+// Тест на потоковую запись без списка кадров и на файл без кадров
+TEST(QGifImageTest, StreamKeepsNoFrames) {
+  const QVector<QRgb> colors = {qRgb(0, 0, 0), qRgb(255, 255, 255)};
+  const std::vector<uchar> pixels(4 * 4, 1);
+  QByteArray data;
+  QBuffer buffer(&data);
+  ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+  QGifImage gif;
+  gif.setGlobalColorTable(colors);
+  gif.setLoopCount(2);
+  ASSERT_TRUE(gif.open(&buffer));
+  ASSERT_FALSE(gif.open(&buffer));
+  // Заголовок и NETSCAPE2.0 записываются вместе с первым кадром, а
+  // записанные кадры не остаются в памяти
+  ASSERT_TRUE(data.isEmpty());
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_TRUE(gif.writeFrame(indexedImage(4, 4, pixels, colors), i * 10));
+    ASSERT_TRUE(data.startsWith("GIF89a"));
+    ASSERT_EQ(0, gif.frameCount());
+  }
+  ASSERT_TRUE(gif.close());
+  ASSERT_FALSE(gif.close());
+  ASSERT_FALSE(gif.writeFrame(indexedImage(4, 4, pixels, colors)));
+  DecodedGif decoded = decodeGif(data.toStdString());
+  ASSERT_NE(nullptr, decoded);
+  ASSERT_EQ(20, decoded->ImageCount);
+  const SavedImage &first = decoded->SavedImages[0];
+  ASSERT_EQ(2, loopCount(first.ExtensionBlockCount, first.ExtensionBlocks));
+
+  QByteArray empty;
+  QBuffer empty_buffer(&empty);
+  ASSERT_TRUE(empty_buffer.open(QIODevice::WriteOnly));
+  QGifImage none;
+  none.setGlobalColorTable(colors);
+  ASSERT_TRUE(none.open(&empty_buffer));
+  ASSERT_TRUE(none.close());
+  decoded = decodeGif(empty.toStdString());
+  ASSERT_NE(nullptr, decoded);
+  ASSERT_EQ(0, decoded->ImageCount);
+  ASSERT_EQ(2, decoded->SColorMap->ColorCount);
+}
+
+// Тест на запись изменившихся областей кадров через GifRecorder
+TEST(GifRecorderTest, WritesChangedRects) {
+  const char *file_name = "recorder.gif";
+  const QRgb background = 0xFF204060u, changed = 0xFFE0C000u;
+  QImage first(16, 12, QImage::Format_ARGB32);
+  first.fill(background);
+  first.setPixel(0, 0, changed);  // Оба цвета попадают в общую палитру
+  QImage second = first;
+  for (int y = 5; y < 7; ++y)
+    for (int x = 9; x < 11; ++x) second.setPixel(x, y, changed);
+  {
+    s21::GifRecorder recorder(file_name, 50);
+    ASSERT_TRUE(recorder.isOpen());
+    ASSERT_TRUE(recorder.addFrame(first));
+    ASSERT_TRUE(recorder.addFrame(QImage()));  // Пропускается кодировщиком
+    ASSERT_TRUE(recorder.addFrame(second));
+    ASSERT_TRUE(recorder.addFrame(second));
+  }
+  std::ifstream file(file_name, std::ios::binary);
+  std::string data((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+  file.close();
+  std::remove(file_name);
+
+  DecodedGif gif = decodeGif(data);
+  ASSERT_NE(nullptr, gif);
+  ASSERT_EQ(16, gif->SWidth);
+  ASSERT_EQ(12, gif->SHeight);
+  ASSERT_EQ(3, gif->ImageCount);
+  // Палитра из двух цветов кадра и прозрачного цвета последним
+  const int transparent = 2;
+  const GifColorType &color = gif->SColorMap->Colors[0];
+  const int changed_index =
+      (color.Red << 16 | color.Green << 8 | color.Blue) ==
+              static_cast<int>(changed & 0xFFFFFF)
+          ? 0
+          : 1;
+  // Полный кадр, область (9, 5, 2, 2), выровненная до (8, 4, 3, 3), и один
+  // прозрачный пиксель на месте неизменившегося кадра
+  const int rects[3][4] = {{0, 0, 16, 12}, {8, 4, 3, 3}, {0, 0, 1, 1}};
+  for (int i = 0; i < 3; ++i) {
+    const SavedImage &image = gif->SavedImages[i];
+    ASSERT_EQ(rects[i][0], image.ImageDesc.Left);
+    ASSERT_EQ(rects[i][1], image.ImageDesc.Top);
+    ASSERT_EQ(rects[i][2], image.ImageDesc.Width);
+    ASSERT_EQ(rects[i][3], image.ImageDesc.Height);
+    ASSERT_EQ(nullptr, image.ImageDesc.ColorMap);
+    GraphicsControlBlock control;
+    ASSERT_EQ(GIF_OK, DGifSavedExtensionToGCB(gif.get(), i, &control));
+    ASSERT_EQ(DISPOSE_DO_NOT, control.DisposalMode);
+    ASSERT_EQ(transparent, control.TransparentColor);
+    ASSERT_EQ(5, control.DelayTime);
+  }
+  for (int y = 0; y < 3; ++y)
+    for (int x = 0; x < 3; ++x) {
+      bool inside = x + 8 >= 9 && y + 4 >= 5;
+      ASSERT_EQ(inside ? changed_index : transparent,
+                gif->SavedImages[1].RasterBits[y * 3 + x]);
+    }
+  ASSERT_EQ(transparent, gif->SavedImages[2].RasterBits[0]);
+}
+
+// Тест на пропуск кадра без ожидания и на закрытие файла кодировщиком
+TEST(GifRecorderTest, DropsFramesWithoutWaiting) {
+  const char *file_name = "dropped.gif";
+  QImage frame(8, 8, QImage::Format_ARGB32);
+  frame.fill(0xFF000000u);
+  {
+    s21::GifRecorder recorder(file_name, 50);
+    ASSERT_TRUE(recorder.addFrame(frame));
+    recorder.finish();
+    ASSERT_FALSE(recorder.addFrame(frame));
+    ASSERT_EQ(1u, recorder.droppedFrames());
+    while (!recorder.isFinished()) std::this_thread::yield();
+  }
+  std::remove(file_name);
+}
+
+// Тест на запись всех кадров с ожиданием кодировщика
+TEST(GifRecorderTest, PushFrameKeepsEveryFrame) {
+  const char *file_name = "pushed.gif";
+  const int count = 40;  // Больше, чем помещается в очередь
+  {
+    s21::GifRecorder recorder(file_name, 30);
+    for (int i = 0; i < count; ++i) {
+      QImage frame(8, 8, QImage::Format_ARGB32);
+      frame.fill(0xFF000000u);
+      frame.setPixel(i % 8, i / 8 % 8, 0xFFFFFFFFu);
+      ASSERT_TRUE(recorder.pushFrame(frame));
+    }
+    ASSERT_EQ(0u, recorder.droppedFrames());
+    recorder.finish();
+    ASSERT_FALSE(recorder.pushFrame(QImage(8, 8, QImage::Format_ARGB32)));
+  }
+  std::ifstream file(file_name, std::ios::binary);
+  std::string data((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+  file.close();
+  std::remove(file_name);
+
+  DecodedGif gif = decodeGif(data);
+  ASSERT_NE(nullptr, gif);
+  ASSERT_EQ(count, gif->ImageCount);
+  for (int i = 0; i < count; ++i) {
+    GraphicsControlBlock gcb;
+    ASSERT_EQ(GIF_OK, DGifSavedExtensionToGCB(gif.get(), i, &gcb));
+    ASSERT_EQ(3, gcb.DelayTime);
+  }
+}
+#endif
+
 // Тест на смещение по X
 TEST(MovingTest, MovingX) {
   s21::Model &model = s21::Model::getInstance();
@@ -99,11 +1213,11 @@ TEST(MovingTest, MovingX) {
   model.coreParser(file_name);
   s21::Affine affine;
   affine.movingX(2);
+  s21::Model::Vertexes vertexes = transformed(model);
   double expect_array[8] = {3.000000, 3.000000, 1.000000, 1.000000,
                             3.000000, 2.999999, 1.000000, 1.000000};
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][0],
-                expect_array[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.x(i), expect_array[i], 1e-6);
   }
   model.releaseResources();
 }
@@ -115,11 +1229,11 @@ TEST(MovingTest, MovingY) {
   model.coreParser(file_name);
   s21::Affine affine;
   affine.movingY(4.5);
+  s21::Model::Vertexes vertexes = transformed(model);
   double expect_array[8] = {3.500000, 3.500000, 3.500000, 3.500000,
                             5.500000, 5.500000, 5.500000, 5.500000};
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][1],
-                expect_array[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.y(i), expect_array[i], 1e-6);
   }
   model.releaseResources();
 }
@@ -131,11 +1245,11 @@ TEST(MovingTest, MovingZ) {
   model.coreParser(file_name);
   s21::Affine affine;
   affine.movingZ(-3);
+  s21::Model::Vertexes vertexes = transformed(model);
   double expect_array[8] = {-4.000000, -2.000000, -2.000000, -4.000000,
                             -3.999999, -1.999999, -2.000000, -4.000000};
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][2],
-                expect_array[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.z(i), expect_array[i], 1e-6);
   }
   model.releaseResources();
 }
@@ -147,17 +1261,16 @@ TEST(MovingTest, RotationX) {
   model.coreParser(file_name);
   s21::Affine affine;
   affine.rotationX(2);
+  s21::Model::Vertexes vertexes = transformed(model);
   double expect_array_y[8] = {1.325444, -0.493151, -0.493151, 1.325444,
                               0.493150, -1.325445, -1.325444, 0.493151};
   double expect_array_z[8] = {-0.493151, -1.325444, -1.325444, -0.493151,
                               1.325444,  0.493150,  0.493151,  1.325444};
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][1],
-                expect_array_y[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.y(i), expect_array_y[i], 1e-6);
   }
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][2],
-                expect_array_z[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.z(i), expect_array_z[i], 1e-6);
   }
   model.releaseResources();
 }
@@ -169,17 +1282,16 @@ TEST(MovingTest, RotationY) {
   model.coreParser(file_name);
   s21::Affine affine;
   affine.rotationY(2);
+  s21::Model::Vertexes vertexes = transformed(model);
   double expect_array_y[8] = {-1.325444, 0.493151, 1.325444, -0.493151,
                               -1.325443, 0.493152, 1.325444, -0.493151};
   double expect_array_z[8] = {-0.493151, -1.325444, 0.493151, 1.325444,
                               -0.493151, -1.325444, 0.493151, 1.325444};
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][0],
-                expect_array_y[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.x(i), expect_array_y[i], 1e-6);
   }
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][2],
-                expect_array_z[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.z(i), expect_array_z[i], 1e-6);
   }
   model.releaseResources();
 }
@@ -191,17 +1303,16 @@ TEST(MovingTest, RotationZ) {
   model.coreParser(file_name);
   s21::Affine affine;
   affine.rotationZ(2);
+  s21::Model::Vertexes vertexes = transformed(model);
   double expect_array_y[8] = {0.493151,  0.493151,  1.325444,  1.325444,
                               -1.325444, -1.325444, -0.493151, -0.493151};
   double expect_array_z[8] = {1.325444, 1.325444, -0.493151, -0.493151,
                               0.493151, 0.493150, -1.325444, -1.325444};
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][0],
-                expect_array_y[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.x(i), expect_array_y[i], 1e-6);
   }
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][1],
-                expect_array_z[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.y(i), expect_array_z[i], 1e-6);
   }
   model.releaseResources();
 }
@@ -213,24 +1324,22 @@ TEST(MovingTest, scaling) {
   model.coreParser(file_name);
   s21::Affine affine;
   affine.scaling(2);
+  s21::Model::Vertexes vertexes = transformed(model);
   double expect_array_x[8] = {2.000000, 2.000000, -2.000000, -2.000000,
                               2.000000, 1.999998, -2.000000, -2.000000};
   double expect_array_y[8] = {-2.000000, -2.000000, -2.000000, -2.000000,
                               2.000000,  2.000000,  2.000000,  2.000000};
   double expect_array_z[8] = {-2.000000, 2.000000, 2.000000, -2.000000,
                               -1.999998, 2.000002, 2.000000, -2.000000};
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][0],
-                expect_array_x[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.x(i), expect_array_x[i], 1e-6);
   }
 
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][1],
-                expect_array_y[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.y(i), expect_array_y[i], 1e-6);
   }
-  for (unsigned int i = 1; i < model.viewer.matrix_of_vertexes.rows; ++i) {
-    ASSERT_NEAR(model.viewer.matrix_of_vertexes.matrix[i][2],
-                expect_array_z[i - 1], 1e-6);
+  for (std::size_t i = 0; i < vertexes.size(); ++i) {
+    ASSERT_NEAR(vertexes.z(i), expect_array_z[i], 1e-6);
   }
   model.releaseResources();
 }
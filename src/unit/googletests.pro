@@ -0,0 +1,36 @@
+# Модульные тесты вместе с тестами кода, которому нужен Qt (запись GIF):
+# в этой сборке определён QT_GUI_LIB. `make tests` собирает тесты без Qt.
+QT       = core gui concurrent
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = googletests
+
+include(../Viewer/QtGifImage/src/gifimage/qtgifimage.pri)
+
+SOURCES += \
+    googletests.cc \
+    ../Viewer/model.cc \
+    ../Viewer/mapped_file.cc \
+    ../Viewer/mesh_cache.cc \
+    ../Viewer/decompressor.cc \
+    ../Viewer/thread_pool.cc \
+    ../Viewer/affine.cc \
+    ../Viewer/transform_kernels.cc \
+    ../Viewer/rasterizer.cc \
+    ../Viewer/color_quantizer.cc \
+    ../Viewer/frame_delta.cc \
+    ../Viewer/gif_recorder.cc
+
+HEADERS += \
+    ../Viewer/bounded_queue.h \
+    ../Viewer/gif_recorder.h
+
+LIBS += -lgtest -lpthread -lz
+
+# Распаковка zstd: `make qt_tests` добавляет CONFIG+=zstd, если есть libzstd
+zstd {
+    DEFINES += S21_WITH_ZSTD
+    LIBS += -lzstd
+}